@@ -7,6 +7,8 @@
 #include "threads/io.h"
 #include "threads/interrupt.h"
 #include "threads/synch.h"
+#include "threads/trace.h"
+#include "threads/workqueue.h"
 
 /* The code in this file is an interface to an ATA (IDE)
    controller.  It attempts to comply to [ATA-3]. */
@@ -72,6 +74,8 @@ struct channel {
 	bool expecting_interrupt;   /* True if an interrupt is expected, false if
 								   any interrupt would be spurious. */
 	struct semaphore completion_wait;   /* Up'd by interrupt handler. */
+	struct work spurious_work;  /* Reports unexpected interrupts. */
+	unsigned spurious_cnt;      /* Unexpected interrupts not yet reported. */
 
 	struct disk devices[2];     /* The devices on this channel. */
 };
@@ -95,6 +99,7 @@ static void select_device (const struct disk *);
 static void select_device_wait (const struct disk *);
 
 static void interrupt_handler (struct intr_frame *);
+static void report_spurious (void *c_);
 
 /* Initialize the disk subsystem and detect disks. */
 void
@@ -119,9 +124,11 @@ disk_init (void) {
 			default:
 				NOT_REACHED ();
 		}
-		lock_init (&c->lock);
+		lock_init_named (&c->lock, c->name);
 		c->expecting_interrupt = false;
 		sema_init (&c->completion_wait, 0);
+		work_init (&c->spurious_work, report_spurious, c);
+		c->spurious_cnt = 0;
 
 		/* Initialize devices. */
 		for (dev_no = 0; dev_no < 2; dev_no++) {
@@ -203,6 +210,13 @@ disk_size (struct disk *d) {
 	return d->capacity;
 }
 
+/* Returns D's number in trace records: CHAN_NO * 2 + DEV_NO, as
+   in the "hdX" device names. */
+static inline int
+disk_id (const struct disk *d) {
+	return (d->channel - channels) * 2 + d->dev_no;
+}
+
 /* Reads sector SEC_NO from disk D into BUFFER, which must have
    room for DISK_SECTOR_SIZE bytes.
    Internally synchronizes accesses to disks, so external
@@ -214,6 +228,8 @@ disk_read (struct disk *d, disk_sector_t sec_no, void *buffer) {
 	ASSERT (d != NULL);
 	ASSERT (buffer != NULL);
 
+	TRACE (TRACE_DISK_READ, disk_id (d), sec_no);
+
 	c = d->channel;
 	lock_acquire (&c->lock);
 	select_sector (d, sec_no);
@@ -238,6 +254,8 @@ disk_write (struct disk *d, disk_sector_t sec_no, const void *buffer) {
 	ASSERT (d != NULL);
 	ASSERT (buffer != NULL);
 
+	TRACE (TRACE_DISK_WRITE, disk_id (d), sec_no);
+
 	c = d->channel;
 	lock_acquire (&c->lock);
 	select_sector (d, sec_no);
@@ -521,14 +539,38 @@ interrupt_handler (struct intr_frame *f) {
 			if (c->expecting_interrupt) {
 				inb (reg_status (c));               /* Acknowledge interrupt. */
 				sema_up (&c->completion_wait);      /* Wake up waiter. */
-			} else
-				printf ("%s: unexpected interrupt\n", c->name);
+			} else {
+				/* Printing goes out over the serial port at a few
+				   thousand characters a second, far too slow for an
+				   interrupt handler, so leave it to a worker. */
+				c->spurious_cnt++;
+				work_schedule (&c->spurious_work);
+			}
 			return;
 		}
 
 	NOT_REACHED ();
 }
 
+/* Reports the unexpected interrupts counted on channel C_ since
+   the last report.  Runs in a work queue worker. */
+static void
+report_spurious (void *c_) {
+	struct channel *c = c_;
+	enum intr_level old_level;
+	unsigned cnt;
+
+	old_level = intr_disable ();
+	cnt = c->spurious_cnt;
+	c->spurious_cnt = 0;
+	intr_set_level (old_level);
+
+	if (cnt == 1)
+		printf ("%s: unexpected interrupt\n", c->name);
+	else if (cnt > 1)
+		printf ("%s: %u unexpected interrupts\n", c->name, cnt);
+}
+
 static void
 inspect_read_cnt (struct intr_frame *f) {
 	struct disk * d = disk_get (f->R.rdx, f->R.rcx);
@@ -5,8 +5,10 @@
 #include <round.h>
 #include <stdio.h>
 
+#include "intrinsic.h"
 #include "threads/interrupt.h"
 #include "threads/io.h"
+#include "threads/profile.h"
 #include "threads/synch.h"
 #include "threads/thread.h"
 
@@ -24,14 +26,100 @@
 /* Number of timer ticks since OS booted. */
 static int64_t ticks;
 
-/* 타이머 틱당 루프 수. timer_calibrate() 함수에 의해 초기화됩니다. */
-/* Number of loops per timer tick.
-   Initialized by timer_calibrate(). */
-static unsigned loops_per_tick;
+/* 8254 입력 주파수와 한 틱에 해당하는 카운터 값. */
+/* 8254 input frequency, and the counter value for one tick. */
+#define PIT_HZ 1193180
+#define PIT_TICK_COUNT ((PIT_HZ + TIMER_FREQ / 2) / TIMER_FREQ)
+
+/* 일회성 모드에서 한 번에 건너뛸 수 있는 최대 틱 수 (16비트 카운터 한계).
+   100 Hz에서는 5틱이므로, 긴 유휴 구간에서는 유휴 루프가 일회성 타이머를
+   연달아 다시 설정하여 인터럽트 수가 약 1/5로 줄어듭니다. */
+/* Most ticks a single one-shot can cover, bounded by the 8254's
+   16-bit counter: 5 ticks at 100 Hz.  A longer idle period is
+   covered by a chain of one-shots, each re-armed by the idle
+   loop, so the 8254 can cut timer interrupts by at most about
+   5x; going further would need a wider timer. */
+#define ONESHOT_MAX_TICKS (0xffff / PIT_TICK_COUNT)
+
+/* 유휴 상태의 동적 틱 모드. */
+/* Dynamic-tick mode for the idle thread. */
+bool timer_tickless;
+
+/* 0이 아니면 PIT가 이만큼의 틱을 덮는 일회성 모드로 설정되어 있습니다. */
+/* If nonzero, the PIT is in one-shot mode covering this many
+   ticks. */
+static int64_t oneshot_ticks;
+
+/* 일회성 타이머가 timer_idle_enter()가 설정한 것이면 true입니다. 이때
+   ONESHOT_COUNT는 설정한 카운터 값이고, ONESHOT_PHASE는 설정 시점에 이미
+   지나 있던 현재 틱의 PIT 카운트입니다. */
+/* True if the pending one-shot was armed by timer_idle_enter(),
+   in which case ONESHOT_COUNT is the count it was programmed with
+   and ONESHOT_PHASE the PIT counts of the current tick that had
+   already passed when it was armed. */
+static bool oneshot_idle;
+static uint16_t oneshot_count;
+static uint16_t oneshot_phase;
+
+/* 유휴 상태에서 인터럽트 없이 지나간 틱 수. */
+/* Number of ticks that passed in idle without an interrupt. */
+static int64_t elided_ticks;
+
+/* 한 틱의 나노초. */
+/* Nanoseconds per timer tick. */
+#define NS_PER_TICK (1000000000 / TIMER_FREQ)
+
+/* TSC 교정에 쓰는 틱 수. */
+/* Timer ticks over which timer_calibrate() counts TSC cycles. */
+#define CALIBRATE_TICKS 4
+
+/* TSC 클럭 소스. timer_calibrate()가 PIT에 맞춰 교정합니다.
+   TSC_BASE 시점의 시각이 NS_BASE이며, 사이클은 32.32 고정 소수점
+   배율 TSC_NS_MULT로 나노초로 바뀝니다. 교정 전에는 TSC_NS_MULT가 0입니다. */
+/* TSC clocksource, calibrated against the PIT by
+   timer_calibrate().  TSC value TSC_BASE corresponds to NS_BASE
+   nanoseconds since boot, and cycles convert to nanoseconds by
+   the 32.32 fixed-point factor TSC_NS_MULT, which is 0 until
+   calibration. */
+static uint64_t tsc_hz;
+static uint64_t tsc_base;
+static int64_t ns_base;
+static uint64_t tsc_ns_mult;
+
+/* 계층적 타이밍 휠.
+   각 레벨은 WHEEL_SIZE개의 슬롯을 가지며, 레벨 N의 슬롯 하나는
+   WHEEL_SIZE^N 틱을 덮습니다. 콜아웃은 만료까지 남은 시간에 맞는 레벨에
+   들어가고, 하위 레벨이 한 바퀴 돌 때마다 상위 레벨의 슬롯 하나가
+   아래로 재분배(cascade)됩니다. 따라서 등록, 취소, 틱 처리가 모두
+   대기 중인 콜아웃 수와 무관하게 O(1) (분할 상환)입니다. */
+/* Hierarchical timing wheel.
+   Each level has WHEEL_SIZE slots, and one slot on level N spans
+   WHEEL_SIZE^N ticks.  A callout is filed on the level that
+   matches how far away it expires, and every time a level wraps
+   around, one slot of the level above is cascaded down.  Adding,
+   cancelling and per-tick processing are therefore O(1)
+   amortized, independent of the number of pending callouts. */
+#define WHEEL_BITS 6
+#define WHEEL_SIZE (1 << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SIZE - 1)
+#define WHEEL_LEVELS 4
+#define WHEEL_MAX_DELTA (((int64_t) 1 << (WHEEL_BITS * WHEEL_LEVELS)) - 1)
+
+static struct list wheel[WHEEL_LEVELS][WHEEL_SIZE];
+
+/* 휠이 다음에 처리할 틱. */
+/* Next tick the wheel will process. */
+static int64_t wheel_next;
 
 static intr_handler_func timer_interrupt;
-static bool too_many_loops(unsigned loops);
-static void busy_wait(int64_t loops);
+static void wheel_insert(struct timer_callout *);
+static bool wheel_cascade(int level);
+static void wheel_advance(int64_t now);
+static int64_t wheel_next_expiry(int64_t limit);
+static void pit_set_periodic(void);
+static void pit_set_oneshot(uint16_t count);
+static uint16_t pit_read(void);
+static bool tsc_invariant(void);
 static void real_time_sleep(int64_t num, int32_t denom);
 
 /* 8254 프로그래머블 인터벌 타이머(PIT)를 설정하여
@@ -41,43 +129,66 @@ static void real_time_sleep(int64_t num, int32_t denom);
    interrupt PIT_FREQ times per second, and registers the
    corresponding interrupt. */
 void timer_init(void) {
-    /* 8254 입력 주파수를 TIMER_FREQ로 나눈 후, 가장 가까운 값으로 반올림합니다. */
-    /* 8254 input frequency divided by TIMER_FREQ, rounded to
-       nearest. */
-    uint16_t count = (1193180 + TIMER_FREQ / 2) / TIMER_FREQ;
+    pit_set_periodic();
 
-    outb(0x43, 0x34); /* CW: counter 0, LSB then MSB, mode 2, binary. */ /* CW: 카운터 0, LSB 후 MSB, 모드 2, 이진형식. */
-    outb(0x40, count & 0xff);
-    outb(0x40, count >> 8);
+    for (int level = 0; level < WHEEL_LEVELS; level++)
+        for (int slot = 0; slot < WHEEL_SIZE; slot++)
+            list_init(&wheel[level][slot]);
+    wheel_next = 1;
 
     intr_register_ext(0x20, timer_interrupt, "8254 Timer");
 }
 
-/* 타이머 틱당 루프 수를 교정합니다. 이 값은 짧은 지연을 구현하는 데 사용됩니다. */
-/* Calibrates loops_per_tick, used to implement brief delays. */
+/* TSC 주파수를 PIT에 맞춰 교정합니다. 틱 경계에서 시작해 CALIBRATE_TICKS 틱
+   동안 TSC가 얼마나 증가하는지 재며, 이후 timer_ns()가 TSC를 사용합니다. */
+/* Calibrates the TSC against the PIT by counting TSC cycles over
+   CALIBRATE_TICKS timer ticks, starting on a tick boundary.
+   From then on timer_ns() reads the TSC.  This takes a few ticks
+   rather than the dozens a busy-loop calibration needs. */
 void timer_calibrate(void) {
-    unsigned high_bit, test_bit;
+    int64_t start;
+    uint64_t tsc_start, tsc_end;
 
     ASSERT(intr_get_level() == INTR_ON);
     printf("Calibrating timer...  ");
 
-    /* 타이머 틱당 최대 2의 제곱 수를 추정합니다. */
-    /* Approximate loops_per_tick as the largest power-of-two
-       still less than one timer tick. */
-    loops_per_tick = 1u << 10;
-    while (!too_many_loops(loops_per_tick << 1)) {
-        loops_per_tick <<= 1;
-        ASSERT(loops_per_tick != 0);
-    }
+    /* 틱 경계를 기다립니다. */
+    /* Wait for a tick boundary. */
+    start = ticks;
+    while (ticks == start)
+        barrier();
 
-    /* 다음 8비트의 loops_per_tick을 미세 조정합니다. */
-    /* Refine the next 8 bits of loops_per_tick. */
-    high_bit = loops_per_tick;
-    for (test_bit = high_bit >> 1; test_bit != high_bit >> 10; test_bit >>= 1)
-        if (!too_many_loops(high_bit | test_bit))
-            loops_per_tick |= test_bit;
+    start = ticks;
+    tsc_start = rdtsc();
+    while (ticks - start < CALIBRATE_TICKS)
+        barrier();
+    tsc_end = rdtsc();
+
+    tsc_hz = (tsc_end - tsc_start) * TIMER_FREQ / CALIBRATE_TICKS;
+    tsc_base = tsc_end;
+    ns_base = (start + CALIBRATE_TICKS) * NS_PER_TICK;
+    tsc_ns_mult = ((uint64_t)1000000000 << 32) / tsc_hz;
+
+    printf("%'" PRIu64 " Hz TSC%s.\n", tsc_hz, tsc_invariant() ? "" : " (not invariant)");
+}
+
+/* 부팅 이후 경과한 나노초를 반환합니다. 교정 후에는 TSC를 읽으므로 틱보다 훨씬
+   정밀하며, 교정 전에는 틱 단위입니다. 인터럽트 핸들러에서도 호출할 수 있습니다. */
+/* Returns nanoseconds since boot.  After timer_calibrate() this
+   reads the TSC and so resolves far below a tick; before it,
+   the result only advances in whole ticks.  Monotonic across
+   calibration.  May be called from an interrupt handler. */
+int64_t timer_ns(void) {
+    if (tsc_ns_mult == 0)
+        return timer_ticks() * NS_PER_TICK;
+    return ns_base + timer_tsc_to_ns(rdtsc() - tsc_base);
+}
 
-    printf("%'" PRIu64 " loops/s.\n", (uint64_t)loops_per_tick * TIMER_FREQ);
+/* TSC 사이클 수 CYCLES를 나노초로 바꿉니다. 교정 전에는 0을 반환합니다. */
+/* Converts CYCLES TSC cycles to nanoseconds, or returns 0 before
+   timer_calibrate(). */
+int64_t timer_tsc_to_ns(uint64_t cycles) {
+    return (unsigned __int128)cycles * tsc_ns_mult >> 32;
 }
 
 /* OS가 부팅된 이후 타이머 틱 수를 반환합니다. */
@@ -100,13 +211,54 @@ int64_t timer_elapsed(int64_t then) {
 /* 지정된 타이머 틱 수만큼 실행을 일시 중지합니다. */
 /* Suspends execution for approximately TICKS timer ticks. */
 void timer_sleep(int64_t ticks) {
-    int64_t start = timer_ticks();
-
     ASSERT(intr_get_level() == INTR_ON);
-    thread_sleep(start + ticks);
+    if (ticks <= 0)
+        return;
+    thread_sleep(ticks);
 }
 
+/* 약 TICKS 타이머 틱 후에 타이머 인터럽트 컨텍스트에서 FUNC(AUX)를
+   호출하도록 CALLOUT을 등록합니다. TICKS가 0 이하이면 다음 틱에 호출됩니다.
+   CALLOUT은 이미 대기 중이어서는 안 됩니다. 인터럽트 핸들러에서 호출할 수 있습니다. */
+/* Arranges for FUNC(AUX) to be called from the timer interrupt
+   about TICKS timer ticks from now, using CALLOUT as storage.
+   A non-positive TICKS fires on the next tick.  CALLOUT must not
+   already be pending.  May be called from an interrupt handler. */
+void timer_add(struct timer_callout *callout, int64_t ticks, timer_callback_func *func, void *aux) {
+    enum intr_level old_level;
+
+    ASSERT(callout != NULL);
+    ASSERT(func != NULL);
+
+    old_level = intr_disable();
+    ASSERT(!callout->pending);
+    callout->expires = timer_ticks() + ticks;
+    callout->func = func;
+    callout->aux = aux;
+    callout->pending = true;
+    wheel_insert(callout);
+    intr_set_level(old_level);
+}
 
+/* 대기 중인 CALLOUT을 취소합니다. 취소했으면 true를, 이미 실행되었거나
+   등록되지 않았으면 false를 반환합니다. */
+/* Cancels CALLOUT.  Returns true if it was pending, false if it
+   already fired or was never added. */
+bool timer_cancel(struct timer_callout *callout) {
+    enum intr_level old_level;
+    bool was_pending;
+
+    ASSERT(callout != NULL);
+
+    old_level = intr_disable();
+    was_pending = callout->pending;
+    if (was_pending) {
+        list_remove(&callout->elem);
+        callout->pending = false;
+    }
+    intr_set_level(old_level);
+    return was_pending;
+}
 
 /* 지정된 밀리초 수만큼 실행을 일시 중지합니다. */
 /* Suspends execution for approximately MS milliseconds. */
@@ -130,52 +282,235 @@ void timer_nsleep(int64_t ns) {
 /* Prints timer statistics. */
 void timer_print_stats(void) {
     printf("Timer: %" PRId64 " ticks\n", timer_ticks());
+    if (timer_tickless)
+        printf("Timer: %" PRId64 " idle ticks without interrupts\n", elided_ticks);
+}
+
+/* 유휴 스레드가 hlt 직전에 호출합니다. 다음 콜아웃까지 두 틱 이상 남았다면
+   PIT를 그 시점에 한 번만 인터럽트하도록 설정합니다. 인터럽트가 꺼져 있어야 합니다. */
+/* Called by the idle thread with interrupts off, just before
+   halting.  If the next pending callout is at least two ticks
+   away, programs the PIT to interrupt once, when it is due,
+   instead of on every tick.  The one-shot is shortened by the
+   part of the current tick that has already passed, so that it
+   fires on a tick boundary. */
+void timer_idle_enter(void) {
+    int64_t delta;
+    uint16_t current;
+
+    ASSERT(intr_get_level() == INTR_OFF);
+
+    if (!timer_tickless || oneshot_ticks != 0)
+        return;
+
+    delta = wheel_next_expiry(ticks + ONESHOT_MAX_TICKS) - ticks;
+    if (delta < 2)
+        return;
+
+    /* 주기 모드의 카운터는 PIT_TICK_COUNT에서 1까지 내려갑니다. */
+    /* In periodic mode the counter runs down from PIT_TICK_COUNT
+       to 1. */
+    current = pit_read();
+    oneshot_phase = current <= PIT_TICK_COUNT ? PIT_TICK_COUNT - current : 0;
+    oneshot_count = delta * PIT_TICK_COUNT - oneshot_phase;
+    pit_set_oneshot(oneshot_count);
+    oneshot_ticks = delta;
+    oneshot_idle = true;
+}
+
+/* 유휴 스레드에서 다른 스레드로 전환될 때 호출됩니다. 일회성 타이머가
+   아직 만료되지 않았다면 지나간 틱만큼 `ticks`를 따라잡고 주기 모드로 되돌립니다.
+   인터럽트가 꺼져 있어야 합니다. */
+/* Called with interrupts off when switching away from the idle
+   thread.  If the one-shot has not fired yet, catches `ticks' up
+   by the whole ticks that have elapsed, doing each tick's
+   thread_idle_tick() work, and re-arms the PIT to interrupt at
+   the end of the partial tick in progress, so that time does not
+   fall behind.  That interrupt counts the tick and restores
+   periodic mode. */
+void timer_idle_exit(void) {
+    uint16_t remaining;
+    int64_t elapsed;
+    int since_tick;
+
+    ASSERT(intr_get_level() == INTR_OFF);
+
+    if (!oneshot_idle)
+        return;
+
+    /* 카운터가 0을 지나 되감겼다면 인터럽트가 이미 대기 중이므로
+       timer_interrupt()가 따라잡기를 처리합니다. */
+    /* If the counter wrapped past zero, the interrupt is already
+       pending and timer_interrupt() will do the catch-up. */
+    remaining = pit_read();
+    if (remaining > oneshot_count)
+        return;
+
+    since_tick = oneshot_phase + (oneshot_count - remaining);
+    elapsed = since_tick / PIT_TICK_COUNT;
+    oneshot_idle = false;
+    oneshot_ticks = 1;
+    pit_set_oneshot(PIT_TICK_COUNT - since_tick % PIT_TICK_COUNT);
+
+    /* 콜아웃은 일회성 만료 시각 이전에는 없으므로 실행될 것은 없지만,
+       휠의 재분배는 진행해야 합니다. */
+    /* No callout is due before the one-shot expiry, so nothing
+       fires here, but the wheel must still cascade. */
+    while (elapsed-- > 0) {
+        ticks++;
+        elided_ticks++;
+        thread_idle_tick();
+    }
+    wheel_advance(ticks);
 }
 
 /* 타이머 인터럽트 핸들러입니다. */
 /* Timer interrupt handler. */
-static void timer_interrupt(struct intr_frame *args UNUSED) {
-    ticks++;
-    thread_tick();
-    thread_wakeup(ticks);
-}
-
-/* 지정된 루프 반복 횟수가 한 타이머 틱을 초과하는 경우 true를 반환합니다. */
-/* Returns true if LOOPS iterations waits for more than one timer
-   tick, otherwise false. */
-static bool too_many_loops(unsigned loops) {
-    /* Wait for a timer tick. */
-    int64_t start = ticks;
-    while (ticks == start)
-        barrier();
+static void timer_interrupt(struct intr_frame *args) {
+    int64_t elapsed = 1;
+
+    if (profile_enabled)
+        profile_sample(args->rip, (args->cs & 3) == 3);
+
+    /* 일회성 타이머가 만료되었다면 건너뛴 틱들을 따라잡습니다. */
+    /* A one-shot expired: catch up on the ticks it covered. */
+    if (oneshot_ticks != 0) {
+        elapsed = oneshot_ticks;
+        elided_ticks += elapsed - 1;
+        oneshot_ticks = 0;
+        oneshot_idle = false;
+        pit_set_periodic();
+    }
 
-    /* Run LOOPS loops. */
-    start = ticks;
-    busy_wait(loops);
+    while (elapsed-- > 0) {
+        ticks++;
+        thread_tick();
+        wheel_advance(ticks);
+    }
+}
 
-    /* 틱 수가 변경된 경우 너무 오랫동안 반복한 것입니다. */
-    /* If the tick count changed, we iterated too long. */
-    barrier();
-    return start != ticks;
+/* PIT를 초당 TIMER_FREQ번 인터럽트하는 주기 모드로 설정합니다. */
+/* Sets the PIT to interrupt TIMER_FREQ times per second. */
+static void pit_set_periodic(void) {
+    uint16_t count = PIT_TICK_COUNT;
+
+    outb(0x43, 0x34); /* CW: counter 0, LSB then MSB, mode 2, binary. */ /* CW: 카운터 0, LSB 후 MSB, 모드 2, 이진형식. */
+    outb(0x40, count & 0xff);
+    outb(0x40, count >> 8);
 }
 
-/* 구현을 위해 간단한 루프 LOOPS를 반복합니다.
-    짧은 지연.
+/* PIT가 COUNT만큼의 입력 클럭 뒤에 한 번 인터럽트하도록 설정합니다. */
+/* Sets the PIT to interrupt once, COUNT input clocks from now. */
+static void pit_set_oneshot(uint16_t count) {
+    outb(0x43, 0x30); /* CW: counter 0, LSB then MSB, mode 0, binary. */ /* CW: 카운터 0, LSB 후 MSB, 모드 0, 이진형식. */
+    outb(0x40, count & 0xff);
+    outb(0x40, count >> 8);
+}
 
-    코드 정렬이 크게 달라질 수 있으므로 NO_INLINE으로 표시했습니다.
-    타이밍에 영향을 미치므로 이 함수가 인라인된 경우
-    장소마다 다르므로 결과가 어려울 수 있습니다.
-    예측하기. */
-/* Iterates through a simple loop LOOPS times, for implementing
-   brief delays.
+/* PIT 카운터 0의 현재 값을 읽습니다. */
+/* Returns the current value of PIT counter 0. */
+static uint16_t pit_read(void) {
+    uint16_t count;
 
-   Marked NO_INLINE because code alignment can significantly
-   affect timings, so that if this function was inlined
-   differently in different places the results would be difficult
-   to predict. */
-static void NO_INLINE busy_wait(int64_t loops) {
-    while (loops-- > 0)
-        barrier();
+    outb(0x43, 0x00); /* CW: latch counter 0. */ /* CW: 카운터 0 래치. */
+    count = inb(0x40);
+    count |= inb(0x40) << 8;
+    return count;
+}
+
+/* CALLOUT을 만료 시각에 맞는 휠 슬롯에 넣습니다. 인터럽트가 꺼져 있어야 합니다. */
+/* Files CALLOUT in the wheel slot matching its expiry.
+   Interrupts must be off. */
+static void wheel_insert(struct timer_callout *callout) {
+    int64_t expires = callout->expires;
+    int64_t delta = expires - wheel_next;
+    struct list *slot;
+
+    if (delta < 0) {
+        /* 이미 지났으면 다음에 처리할 틱에 실행합니다. */
+        /* Already due: run on the next processed tick. */
+        slot = &wheel[0][wheel_next & WHEEL_MASK];
+    } else {
+        int level = 0;
+
+        /* 너무 먼 콜아웃은 가장 높은 레벨에 넣고, 재분배 시 다시 배치합니다. */
+        /* Clamp far-away callouts to the top level; cascading
+           re-files them using the real expiry. */
+        if (delta > WHEEL_MAX_DELTA)
+            expires = wheel_next + WHEEL_MAX_DELTA;
+        while (level < WHEEL_LEVELS - 1 && delta >= (int64_t) 1 << (WHEEL_BITS * (level + 1)))
+            level++;
+        slot = &wheel[level][(expires >> (WHEEL_BITS * level)) & WHEEL_MASK];
+    }
+    list_push_back(slot, &callout->elem);
+}
+
+/* LEVEL의 현재 슬롯에 있는 콜아웃들을 아래 레벨로 재분배합니다.
+   이 레벨이 한 바퀴를 돌았으면(슬롯 번호가 0이면) true를 반환합니다. */
+/* Re-files the callouts in LEVEL's current slot onto lower
+   levels.  Returns true if LEVEL has wrapped around, that is, if
+   the slot just cascaded is slot 0. */
+static bool wheel_cascade(int level) {
+    int index = (wheel_next >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    struct list *slot = &wheel[level][index];
+
+    while (!list_empty(slot))
+        wheel_insert(list_entry(list_pop_front(slot), struct timer_callout, elem));
+    return index == 0;
+}
+
+/* NOW까지의 모든 틱을 처리하며 만료된 콜아웃을 실행합니다. */
+/* Processes every tick up to NOW, running expired callouts. */
+static void wheel_advance(int64_t now) {
+    ASSERT(intr_get_level() == INTR_OFF);
+
+    while (wheel_next <= now) {
+        struct list *slot = &wheel[0][wheel_next & WHEEL_MASK];
+
+        if ((wheel_next & WHEEL_MASK) == 0) {
+            int level = 1;
+            while (level < WHEEL_LEVELS && wheel_cascade(level))
+                level++;
+        }
+        wheel_next++;
+
+        while (!list_empty(slot)) {
+            struct timer_callout *callout = list_entry(list_pop_front(slot), struct timer_callout, elem);
+            callout->pending = false;
+            callout->func(callout->aux);
+        }
+    }
+}
+
+/* LIMIT 이전에 콜아웃이 실행될 수 있는 가장 이른 틱을 반환하고, 없으면 LIMIT을
+   반환합니다. 재분배가 일어나는 틱은 콜아웃을 만들 수 있으므로 보수적으로 포함합니다. */
+/* Returns the earliest tick before LIMIT at which a callout may
+   fire, or LIMIT if there is none.  Ticks that cascade an upper
+   level are conservatively treated as due. */
+static int64_t wheel_next_expiry(int64_t limit) {
+    int64_t t;
+
+    for (t = wheel_next; t < limit; t++)
+        if ((t & WHEEL_MASK) == 0 || !list_empty(&wheel[0][t & WHEEL_MASK]))
+            return t;
+    return limit;
+}
+
+/* TSC가 불변(invariant)이면, 즉 전력 상태와 무관하게 일정한 속도로 증가하면
+   true를 반환합니다. */
+/* Returns true if the CPU reports an invariant TSC, one that
+   ticks at a constant rate regardless of power state. */
+static bool tsc_invariant(void) {
+    uint32_t eax = 0x80000000, ebx, ecx = 0, edx;
+
+    __asm __volatile("cpuid" : "+a"(eax), "=b"(ebx), "+c"(ecx), "=d"(edx));
+    if (eax < 0x80000007)
+        return false;
+
+    eax = 0x80000007;
+    ecx = 0;
+    __asm __volatile("cpuid" : "+a"(eax), "=b"(ebx), "+c"(ecx), "=d"(edx));
+    return (edx & (1u << 8)) != 0;
 }
 
 /* 대략적으로 NUM/DENOM 초만큼 실행을 중지합니다. */
@@ -198,12 +533,15 @@ static void real_time_sleep(int64_t num, int32_t denom) {
            processes. */
         timer_sleep(ticks);
     } else {
-        /* 그렇지 않으면, 더 정확한 서브-틱 타이밍을 위해 바쁜 대기 루프를 사용합니다.
-           오버플로우 가능성을 피하기 위해 분자와 분모를 1000으로 나눕니다. */
-        /* Otherwise, use a busy-wait loop for more accurate
-           sub-tick timing.  We scale the numerator and denominator
-           down by 1000 to avoid the possibility of overflow. */
-        ASSERT(denom % 1000 == 0);
-        busy_wait(loops_per_tick * num / 1000 * TIMER_FREQ / (denom / 1000));
+        /* 그렇지 않으면, 더 정확한 서브-틱 타이밍을 위해 TSC를 보며 바쁜 대기를 합니다.
+           DENOM은 10^9의 약수입니다. */
+        /* Otherwise, busy-wait on the TSC clock for more accurate
+           sub-tick timing.  DENOM divides 10^9. */
+        int64_t deadline;
+
+        ASSERT(1000000000 % denom == 0);
+        deadline = timer_ns() + num * (1000000000 / denom);
+        while (timer_ns() < deadline)
+            barrier();
     }
 }
@@ -22,6 +22,8 @@ filesys_init (bool format) {
 		PANIC ("hd0:1 (hdb) not present, file system initialization failed");
 
 	inode_init ();
+	dir_init ();
+	file_init ();
 
 #ifdef EFILESYS
 	fat_init ();
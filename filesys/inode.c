@@ -6,10 +6,22 @@
 #include "filesys/filesys.h"
 #include "filesys/free-map.h"
 #include "threads/malloc.h"
+#include "threads/palloc.h"
+#include "threads/synch.h"
+#include "threads/vaddr.h"
 
 /* Identifies an inode. */
 #define INODE_MAGIC 0x494e4f44
 
+/* Bytes copied between a user buffer and an inode per
+ * acquisition of the inode's lock, when a page can be had for
+ * the transfer. */
+#define BOUNCE_SIZE PGSIZE
+
+/* Size of the bounce buffer on the stack, used for short user
+ * transfers and for any user transfer when no page is free. */
+#define SMALL_BOUNCE_SIZE 128
+
 /* On-disk inode.
  * Must be exactly DISK_SECTOR_SIZE bytes long. */
 struct inode_disk {
@@ -33,7 +45,13 @@ struct inode {
 	int open_cnt;                       /* Number of openers. */
 	bool removed;                       /* True if deleted, false otherwise. */
 	int deny_write_cnt;                 /* 0: writes ok, >0: deny writes. */
+	struct rwlock rwlock;               /* Serializes writes against I/O. */
 	struct inode_disk data;             /* Inode content. */
+
+	/* Scratch space for partial sectors.  Writers use it holding
+	 * RWLOCK exclusively, readers holding SCRATCH_LOCK. */
+	struct lock scratch_lock;
+	uint8_t scratch[DISK_SECTOR_SIZE];
 };
 
 /* Returns the disk sector that contains byte offset POS within
@@ -53,10 +71,17 @@ byte_to_sector (const struct inode *inode, off_t pos) {
  * returns the same `struct inode'. */
 static struct list open_inodes;
 
+/* Protects open_inodes and the open_cnt and removed members of
+ * every inode on it.  Data I/O happens under each inode's own
+ * rwlock instead, so accesses to unrelated files, including
+ * their disk transfers, do not wait for each other. */
+static struct lock open_inodes_lock;
+
 /* Initializes the inode module. */
 void
 inode_init (void) {
 	list_init (&open_inodes);
+	lock_init (&open_inodes_lock);
 }
 
 /* Initializes an inode with LENGTH bytes of data and
@@ -104,36 +129,49 @@ inode_open (disk_sector_t sector) {
 	struct list_elem *e;
 	struct inode *inode;
 
+	lock_acquire (&open_inodes_lock);
+
 	/* Check whether this inode is already open. */
 	for (e = list_begin (&open_inodes); e != list_end (&open_inodes);
 			e = list_next (e)) {
 		inode = list_entry (e, struct inode, elem);
 		if (inode->sector == sector) {
-			inode_reopen (inode);
+			inode->open_cnt++;
+			lock_release (&open_inodes_lock);
 			return inode; 
 		}
 	}
 
 	/* Allocate memory. */
 	inode = malloc (sizeof *inode);
-	if (inode == NULL)
+	if (inode == NULL) {
+		lock_release (&open_inodes_lock);
 		return NULL;
+	}
 
-	/* Initialize. */
+	/* Initialize.  The inode is read while still holding the
+	 * lock, so that a concurrent opener of the same sector never
+	 * sees it half-initialized. */
 	list_push_front (&open_inodes, &inode->elem);
 	inode->sector = sector;
 	inode->open_cnt = 1;
 	inode->deny_write_cnt = 0;
 	inode->removed = false;
+	rw_init (&inode->rwlock);
+	lock_init (&inode->scratch_lock);
 	disk_read (filesys_disk, inode->sector, &inode->data);
+	lock_release (&open_inodes_lock);
 	return inode;
 }
 
 /* Reopens and returns INODE. */
 struct inode *
 inode_reopen (struct inode *inode) {
-	if (inode != NULL)
+	if (inode != NULL) {
+		lock_acquire (&open_inodes_lock);
 		inode->open_cnt++;
+		lock_release (&open_inodes_lock);
+	}
 	return inode;
 }
 
@@ -153,9 +191,11 @@ inode_close (struct inode *inode) {
 		return;
 
 	/* Release resources if this was the last opener. */
+	lock_acquire (&open_inodes_lock);
 	if (--inode->open_cnt == 0) {
 		/* Remove from inode list and release lock. */
 		list_remove (&inode->elem);
+		lock_release (&open_inodes_lock);
 
 		/* Deallocate blocks if removed. */
 		if (inode->removed) {
@@ -165,7 +205,8 @@ inode_close (struct inode *inode) {
 		}
 
 		free (inode); 
-	}
+	} else
+		lock_release (&open_inodes_lock);
 }
 
 /* Marks INODE to be deleted when it is closed by the last caller who
@@ -173,17 +214,17 @@ inode_close (struct inode *inode) {
 void
 inode_remove (struct inode *inode) {
 	ASSERT (inode != NULL);
+	lock_acquire (&open_inodes_lock);
 	inode->removed = true;
+	lock_release (&open_inodes_lock);
 }
 
-/* Reads SIZE bytes from INODE into BUFFER, starting at position OFFSET.
- * Returns the number of bytes actually read, which may be less
- * than SIZE if an error occurs or end of file is reached. */
-off_t
-inode_read_at (struct inode *inode, void *buffer_, off_t size, off_t offset) {
-	uint8_t *buffer = buffer_;
+/* Reads up to SIZE bytes from INODE into kernel buffer DATA,
+ * starting at position OFFSET.  Returns the number of bytes
+ * actually read.  INODE's lock must be held. */
+static off_t
+read_chunk (struct inode *inode, uint8_t *data, off_t size, off_t offset) {
 	off_t bytes_read = 0;
-	uint8_t *bounce = NULL;
 
 	while (size > 0) {
 		/* Disk sector to read, starting byte offset within sector. */
@@ -201,18 +242,15 @@ inode_read_at (struct inode *inode, void *buffer_, off_t size, off_t offset) {
 			break;
 
 		if (sector_ofs == 0 && chunk_size == DISK_SECTOR_SIZE) {
-			/* Read full sector directly into caller's buffer. */
-			disk_read (filesys_disk, sector_idx, buffer + bytes_read); 
+			/* Read full sector directly into DATA. */
+			disk_read (filesys_disk, sector_idx, data + bytes_read);
 		} else {
-			/* Read sector into bounce buffer, then partially copy
-			 * into caller's buffer. */
-			if (bounce == NULL) {
-				bounce = malloc (DISK_SECTOR_SIZE);
-				if (bounce == NULL)
-					break;
-			}
-			disk_read (filesys_disk, sector_idx, bounce);
-			memcpy (buffer + bytes_read, bounce + sector_ofs, chunk_size);
+			/* Read sector into the scratch space, then partially
+			 * copy into DATA. */
+			lock_acquire (&inode->scratch_lock);
+			disk_read (filesys_disk, sector_idx, inode->scratch);
+			memcpy (data + bytes_read, inode->scratch + sector_ofs, chunk_size);
+			lock_release (&inode->scratch_lock);
 		}
 
 		/* Advance. */
@@ -220,25 +258,87 @@ inode_read_at (struct inode *inode, void *buffer_, off_t size, off_t offset) {
 		offset += chunk_size;
 		bytes_read += chunk_size;
 	}
-	free (bounce);
 
 	return bytes_read;
 }
 
-/* Writes SIZE bytes from BUFFER into INODE, starting at OFFSET.
- * Returns the number of bytes actually written, which may be
- * less than SIZE if end of file is reached or an error occurs.
- * (Normally a write at end of file would extend the inode, but
- * growth is not yet implemented.) */
+/* Returns a kernel buffer for copying SIZE bytes to or from
+ * user memory and stores its size in *BOUNCE_SIZE.  A transfer
+ * longer than SMALL, which must be SMALL_BOUNCE_SIZE bytes, gets
+ * a page if one is free.  Otherwise it goes through SMALL, so
+ * running short of pages slows a transfer down but never cuts it
+ * short.  Release the buffer with bounce_put(). */
+static uint8_t *
+bounce_get (off_t size, uint8_t *small, off_t *bounce_size) {
+	uint8_t *page;
+
+	if (size > SMALL_BOUNCE_SIZE && (page = palloc_get_page (0)) != NULL) {
+		*bounce_size = BOUNCE_SIZE;
+		return page;
+	}
+	*bounce_size = SMALL_BOUNCE_SIZE;
+	return small;
+}
+
+/* Releases BOUNCE, obtained from bounce_get() with SMALL. */
+static void
+bounce_put (uint8_t *bounce, uint8_t *small) {
+	if (bounce != small)
+		palloc_free_page (bounce);
+}
+
+/* Reads SIZE bytes from INODE into BUFFER, starting at position OFFSET.
+ * Returns the number of bytes actually read, which may be less
+ * than SIZE if an error occurs or end of file is reached.
+ * Readers of the same inode proceed concurrently.
+ *
+ * A kernel BUFFER is filled directly.  A user BUFFER is only
+ * touched with INODE's lock released, through a kernel bounce
+ * buffer: its page fault may need this same inode, to load an
+ * mmap'd page or to write back an evicted one, and the lock is
+ * not recursive. */
 off_t
-inode_write_at (struct inode *inode, const void *buffer_, off_t size,
+inode_read_at (struct inode *inode, void *buffer_, off_t size, off_t offset) {
+	uint8_t *buffer = buffer_;
+	uint8_t small[SMALL_BOUNCE_SIZE];
+	uint8_t *bounce;
+	off_t bounce_size;
+	off_t bytes_read = 0;
+
+	if (!is_user_vaddr (buffer)) {
+		rw_read_acquire (&inode->rwlock);
+		bytes_read = read_chunk (inode, buffer, size, offset);
+		rw_read_release (&inode->rwlock);
+		return bytes_read;
+	}
+
+	bounce = bounce_get (size, small, &bounce_size);
+	while (size > 0) {
+		off_t chunk_size = size < bounce_size ? size : bounce_size;
+		off_t chunk_read;
+
+		rw_read_acquire (&inode->rwlock);
+		chunk_read = read_chunk (inode, bounce, chunk_size, offset);
+		rw_read_release (&inode->rwlock);
+
+		memcpy (buffer + bytes_read, bounce, chunk_read);
+		size -= chunk_read;
+		offset += chunk_read;
+		bytes_read += chunk_read;
+		if (chunk_read < chunk_size)
+			break;
+	}
+	bounce_put (bounce, small);
+	return bytes_read;
+}
+
+/* Writes up to SIZE bytes from kernel buffer DATA into INODE,
+ * starting at OFFSET.  Returns the number of bytes actually
+ * written.  INODE's lock must be held exclusively. */
+static off_t
+write_chunk (struct inode *inode, const uint8_t *data, off_t size,
 		off_t offset) {
-	const uint8_t *buffer = buffer_;
 	off_t bytes_written = 0;
-	uint8_t *bounce = NULL;
-
-	if (inode->deny_write_cnt)
-		return 0;
 
 	while (size > 0) {
 		/* Sector to write, starting byte offset within sector. */
@@ -257,24 +357,17 @@ inode_write_at (struct inode *inode, const void *buffer_, off_t size,
 
 		if (sector_ofs == 0 && chunk_size == DISK_SECTOR_SIZE) {
 			/* Write full sector directly to disk. */
-			disk_write (filesys_disk, sector_idx, buffer + bytes_written); 
+			disk_write (filesys_disk, sector_idx, data + bytes_written);
 		} else {
-			/* We need a bounce buffer. */
-			if (bounce == NULL) {
-				bounce = malloc (DISK_SECTOR_SIZE);
-				if (bounce == NULL)
-					break;
-			}
-
 			/* If the sector contains data before or after the chunk
 			   we're writing, then we need to read in the sector
 			   first.  Otherwise we start with a sector of all zeros. */
 			if (sector_ofs > 0 || chunk_size < sector_left) 
-				disk_read (filesys_disk, sector_idx, bounce);
+				disk_read (filesys_disk, sector_idx, inode->scratch);
 			else
-				memset (bounce, 0, DISK_SECTOR_SIZE);
-			memcpy (bounce + sector_ofs, buffer + bytes_written, chunk_size);
-			disk_write (filesys_disk, sector_idx, bounce); 
+				memset (inode->scratch, 0, DISK_SECTOR_SIZE);
+			memcpy (inode->scratch + sector_ofs, data + bytes_written, chunk_size);
+			disk_write (filesys_disk, sector_idx, inode->scratch); 
 		}
 
 		/* Advance. */
@@ -282,18 +375,68 @@ inode_write_at (struct inode *inode, const void *buffer_, off_t size,
 		offset += chunk_size;
 		bytes_written += chunk_size;
 	}
-	free (bounce);
 
 	return bytes_written;
 }
 
+/* Writes SIZE bytes from BUFFER into INODE, starting at OFFSET.
+ * Returns the number of bytes actually written, which may be
+ * less than SIZE if end of file is reached or an error occurs.
+ * (Normally a write at end of file would extend the inode, but
+ * growth is not yet implemented.)
+ *
+ * As in inode_read_at(), a user BUFFER is copied through a kernel
+ * bounce buffer with INODE's lock released, so such a write is
+ * atomic with respect to other readers and writers only one
+ * bounce buffer at a time. */
+off_t
+inode_write_at (struct inode *inode, const void *buffer_, off_t size,
+		off_t offset) {
+	const uint8_t *buffer = buffer_;
+	uint8_t small[SMALL_BOUNCE_SIZE];
+	uint8_t *bounce;
+	off_t bounce_size;
+	off_t bytes_written = 0;
+
+	if (!is_user_vaddr (buffer)) {
+		rw_write_acquire (&inode->rwlock);
+		if (!inode->deny_write_cnt)
+			bytes_written = write_chunk (inode, buffer, size, offset);
+		rw_write_release (&inode->rwlock);
+		return bytes_written;
+	}
+
+	bounce = bounce_get (size, small, &bounce_size);
+	while (size > 0) {
+		off_t chunk_size = size < bounce_size ? size : bounce_size;
+		off_t chunk_written = 0;
+
+		memcpy (bounce, buffer + bytes_written, chunk_size);
+
+		rw_write_acquire (&inode->rwlock);
+		if (!inode->deny_write_cnt)
+			chunk_written = write_chunk (inode, bounce, chunk_size, offset);
+		rw_write_release (&inode->rwlock);
+
+		size -= chunk_written;
+		offset += chunk_written;
+		bytes_written += chunk_written;
+		if (chunk_written < chunk_size)
+			break;
+	}
+	bounce_put (bounce, small);
+	return bytes_written;
+}
+
 /* Disables writes to INODE.
    May be called at most once per inode opener. */
 	void
 inode_deny_write (struct inode *inode) 
 {
+	rw_write_acquire (&inode->rwlock);
 	inode->deny_write_cnt++;
 	ASSERT (inode->deny_write_cnt <= inode->open_cnt);
+	rw_write_release (&inode->rwlock);
 }
 
 /* Re-enables writes to INODE.
@@ -301,9 +444,11 @@ inode_deny_write (struct inode *inode)
  * inode_deny_write() on the inode, before closing the inode. */
 void
 inode_allow_write (struct inode *inode) {
+	rw_write_acquire (&inode->rwlock);
 	ASSERT (inode->deny_write_cnt > 0);
 	ASSERT (inode->deny_write_cnt <= inode->open_cnt);
 	inode->deny_write_cnt--;
+	rw_write_release (&inode->rwlock);
 }
 
 /* Returns the length, in bytes, of INODE's data. */
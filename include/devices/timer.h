@@ -1,7 +1,9 @@
 #ifndef DEVICES_TIMER_H
 #define DEVICES_TIMER_H
 
+#include <list.h>
 #include <round.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 /* Number of timer interrupts per second. */
@@ -12,6 +14,8 @@ void timer_calibrate (void);
 
 int64_t timer_ticks (void);
 int64_t timer_elapsed (int64_t);
+int64_t timer_ns (void);
+int64_t timer_tsc_to_ns (uint64_t cycles);
 
 void timer_sleep (int64_t ticks);
 void timer_msleep (int64_t milliseconds);
@@ -20,4 +24,35 @@ void timer_nsleep (int64_t nanoseconds);
 
 void timer_print_stats (void);
 
+/* true이면 유휴 상태에서 주기적인 틱 대신 일회성 타이머를 사용합니다.
+   커널 명령 줄 옵션 "-tickless"에 의해 제어됩니다. */
+/* If true, the idle thread replaces periodic ticks with a
+   one-shot timer for the next pending callout.
+   Controlled by kernel command-line option "-tickless". */
+extern bool timer_tickless;
+
+void timer_idle_enter (void);
+void timer_idle_exit (void);
+
+/* 타이머 콜백 함수. 타이머 인터럽트 컨텍스트에서 호출됩니다. */
+/* Timer callback.  Runs in the timer interrupt's context, so it
+   must not sleep. */
+typedef void timer_callback_func (void *aux);
+
+/* 타이머 휠에 등록되는 콜아웃. 저장 공간은 호출자가 소유합니다. */
+/* A callout registered on the timer wheel.  The storage is owned
+   by the caller and must stay valid until the callout fires or is
+   cancelled. */
+struct timer_callout {
+	struct list_elem elem;      /* Element in a wheel slot. */
+	int64_t expires;            /* Tick at which to fire. */
+	timer_callback_func *func;  /* Function to call. */
+	void *aux;                  /* Argument to FUNC. */
+	bool pending;               /* On the wheel? */
+};
+
+void timer_add (struct timer_callout *, int64_t ticks,
+                timer_callback_func *, void *aux);
+bool timer_cancel (struct timer_callout *);
+
 #endif /* devices/timer.h */
@@ -0,0 +1,60 @@
+#ifndef __LIB_KERNEL_PHEAP_H
+#define __LIB_KERNEL_PHEAP_H
+
+/* Pairing heap.
+ *
+ * A self-adjusting heap: insertion and finding the least element
+ * are O(1), and removing the least element or an arbitrary
+ * element is O(log n) amortized.  Removing and reinserting an
+ * element is the way to tell the heap that its key changed.
+ *
+ * Like the list and hash table implementations, the heap does
+ * not use dynamic allocation.  Each structure that can be in a
+ * heap must embed a struct pheap_elem member, and pheap_entry()
+ * converts a struct pheap_elem back into the structure that
+ * contains it. */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Heap element. */
+struct pheap_elem {
+	struct pheap_elem *prev;    /* Parent if leftmost child, else
+	                               previous sibling; NULL for root. */
+	struct pheap_elem *child;   /* Leftmost child. */
+	struct pheap_elem *sibling; /* Next sibling. */
+};
+
+/* Converts pointer to heap element PHEAP_ELEM into a pointer to
+ * the structure that PHEAP_ELEM is embedded inside.  Supply the
+ * name of the outer structure STRUCT and the member name MEMBER
+ * of the heap element. */
+#define pheap_entry(PHEAP_ELEM, STRUCT, MEMBER)     \
+	((STRUCT *) ((uint8_t *) (PHEAP_ELEM)       \
+		- offsetof (STRUCT, MEMBER)))
+
+/* Compares the value of two heap elements A and B, given
+ * auxiliary data AUX.  Returns true if A should leave the heap
+ * before B. */
+typedef bool pheap_less_func (const struct pheap_elem *a,
+		const struct pheap_elem *b, void *aux);
+
+/* Pairing heap. */
+struct pheap {
+	struct pheap_elem *root;    /* Least element, or NULL if empty. */
+	size_t elem_cnt;            /* Number of elements. */
+	pheap_less_func *less;      /* Comparison function. */
+	void *aux;                  /* Auxiliary data for `less'. */
+};
+
+void pheap_init (struct pheap *, pheap_less_func *, void *aux);
+
+void pheap_insert (struct pheap *, struct pheap_elem *);
+void pheap_remove (struct pheap *, struct pheap_elem *);
+struct pheap_elem *pheap_pop (struct pheap *);
+
+struct pheap_elem *pheap_top (struct pheap *);
+bool pheap_empty (struct pheap *);
+
+#endif /* lib/kernel/pheap.h */
@@ -36,6 +36,13 @@ enum {
 
 	SYS_MOUNT,
 	SYS_UMOUNT,
+
+	/* Extra: timekeeping. */
+	SYS_CLOCK,                  /* Nanoseconds since boot. */
+
+	/* Extra: user-space synchronization. */
+	SYS_FUTEX_WAIT,             /* Sleep while a word holds a value. */
+	SYS_FUTEX_WAKE,             /* Wake threads sleeping on a word. */
 };
 
 #endif /* lib/syscall-nr.h */
@@ -0,0 +1,38 @@
+#ifndef __LIB_USER_SYNCH_H
+#define __LIB_USER_SYNCH_H
+
+#include <stdbool.h>
+
+/* User-level synchronization built on futex_wait() and
+   futex_wake().  The uncontended paths are a single atomic
+   instruction and do not enter the kernel.
+
+   They do not synchronize separate processes.  A futex on a
+   word of a mapped file is keyed by the file and offset, so its
+   wake-ups reach every process mapping the file, but each
+   process maps a private copy of the page.  A mutex or condition
+   variable placed in such a mapping is therefore a separate
+   object in each process and gives no mutual exclusion across
+   them. */
+
+/* Mutex. */
+struct mutex {
+	int state;                  /* 0: free, 1: held, 2: held, maybe waiters. */
+};
+
+void mutex_init (struct mutex *);
+void mutex_lock (struct mutex *);
+bool mutex_trylock (struct mutex *);
+void mutex_unlock (struct mutex *);
+
+/* Condition variable. */
+struct condvar {
+	int seq;                    /* Bumped by every signal or broadcast. */
+};
+
+void condvar_init (struct condvar *);
+void condvar_wait (struct condvar *, struct mutex *);
+void condvar_signal (struct condvar *);
+void condvar_broadcast (struct condvar *);
+
+#endif /* lib/user/synch.h */
@@ -0,0 +1,82 @@
+#ifndef THREADS_FIXED_POINT_H
+#define THREADS_FIXED_POINT_H
+
+#include <stdint.h>
+
+/* 17.14 고정 소수점 수입니다.
+   커널은 부동 소수점 연산을 사용할 수 없으므로, 다중 수준 피드백 큐
+   스케줄러의 recent_cpu와 load_avg는 이 형식으로 계산합니다.
+   부호 비트 1개, 정수부 17비트, 소수부 14비트로 구성됩니다. */
+/* 17.14 fixed-point real numbers.
+   The kernel cannot use floating point, so the multi-level
+   feedback queue scheduler keeps recent_cpu and load_avg in this
+   format: one sign bit, 17 integer bits and 14 fraction bits. */
+typedef int fixed_t;
+
+#define FP_SHIFT 14
+#define FP_F (1 << FP_SHIFT)            /* 1.0 in 17.14. */
+
+/* 정수 N을 고정 소수점으로 변환합니다. */
+/* Converts integer N to fixed point. */
+static inline fixed_t
+fp_from_int (int n) {
+	return n * FP_F;
+}
+
+/* X를 0 방향으로 버림하여 정수로 변환합니다. */
+/* Converts X to an integer, rounding toward zero. */
+static inline int
+fp_to_int (fixed_t x) {
+	return x / FP_F;
+}
+
+/* X를 가장 가까운 정수로 반올림합니다. */
+/* Converts X to the nearest integer. */
+static inline int
+fp_round (fixed_t x) {
+	return x >= 0 ? (x + FP_F / 2) / FP_F : (x - FP_F / 2) / FP_F;
+}
+
+static inline fixed_t
+fp_add (fixed_t x, fixed_t y) {
+	return x + y;
+}
+
+static inline fixed_t
+fp_sub (fixed_t x, fixed_t y) {
+	return x - y;
+}
+
+static inline fixed_t
+fp_add_int (fixed_t x, int n) {
+	return x + n * FP_F;
+}
+
+static inline fixed_t
+fp_sub_int (fixed_t x, int n) {
+	return x - n * FP_F;
+}
+
+/* 곱셈 중간값은 32비트를 넘을 수 있으므로 64비트로 계산합니다. */
+/* The intermediate product can overflow 32 bits, so widen it. */
+static inline fixed_t
+fp_mul (fixed_t x, fixed_t y) {
+	return ((int64_t) x) * y / FP_F;
+}
+
+static inline fixed_t
+fp_mul_int (fixed_t x, int n) {
+	return x * n;
+}
+
+static inline fixed_t
+fp_div (fixed_t x, fixed_t y) {
+	return ((int64_t) x) * FP_F / y;
+}
+
+static inline fixed_t
+fp_div_int (fixed_t x, int n) {
+	return x / n;
+}
+
+#endif /* threads/fixed-point.h */
@@ -4,10 +4,23 @@
 #include <debug.h>
 #include <stddef.h>
 
+/* Number of smallest size classes that have per-thread
+   magazines, and the number of free blocks a magazine holds. */
+#define MAG_CLASS_CNT 8
+#define MAG_SIZE 8
+
+/* Per-thread cache of free blocks of one size class. */
+struct magazine {
+	void *blocks;               /* Singly linked free blocks. */
+	unsigned cnt;               /* Number of blocks. */
+};
+
 void malloc_init (void);
 void *malloc (size_t) __attribute__ ((malloc));
 void *calloc (size_t, size_t) __attribute__ ((malloc));
 void *realloc (void *, size_t);
 void free (void *);
+size_t malloc_usable_size (void *);
+void malloc_thread_exit (void);
 
 #endif /* threads/malloc.h */
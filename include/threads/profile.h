@@ -0,0 +1,24 @@
+#ifndef THREADS_PROFILE_H
+#define THREADS_PROFILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* 통계적 프로파일러입니다.
+   타이머 인터럽트마다 중단된 명령어 주소(rip)를 해시 히스토그램에 세고,
+   print_stats()에서 가장 많이 나온 주소들을 utils/backtrace로 심볼화할 수
+   있는 형식으로 출력합니다. 커널 명령 줄 옵션 "-profile"로 켭니다. */
+/* Statistical profiler.
+   Each timer interrupt counts the interrupted instruction
+   address (rip) in a hash histogram, and print_stats() reports
+   the hottest addresses in a form utils/backtrace can
+   symbolize.  Enabled by kernel command-line option
+   "-profile". */
+
+extern bool profile_enabled;
+
+void profile_init (void);
+void profile_sample (uintptr_t rip, bool user);
+void profile_print_stats (void);
+
+#endif /* threads/profile.h */
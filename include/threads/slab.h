@@ -0,0 +1,35 @@
+#ifndef THREADS_SLAB_H
+#define THREADS_SLAB_H
+
+#include <list.h>
+#include <stddef.h>
+#include "threads/synch.h"
+
+/* Object constructor.  Called once on each object when its slab
+   is created, not on every allocation. */
+typedef void slab_ctor_func (void *obj);
+
+/* A cache of equally sized objects of one type. */
+struct slab_cache {
+	const char *name;           /* Name, for statistics. */
+	size_t obj_size;            /* Object size as requested. */
+	size_t stride;              /* Bytes per object, free link included. */
+	size_t objs_per_slab;       /* Objects in each one-page slab. */
+	slab_ctor_func *ctor;       /* Constructor, or null. */
+	struct lock lock;           /* Protects the members below. */
+	struct list partial;        /* Slabs with some objects free. */
+	struct list full;           /* Slabs with no objects free. */
+	struct slab *empty;         /* One wholly free slab kept in reserve. */
+	size_t slab_cnt;            /* Slabs held, including EMPTY. */
+	size_t in_use;              /* Objects allocated. */
+	struct list_elem elem;      /* Element in the list of all caches. */
+};
+
+void slab_init (void);
+void slab_cache_init (struct slab_cache *, const char *name, size_t size,
+		slab_ctor_func *);
+void *slab_alloc (struct slab_cache *);
+void slab_free (struct slab_cache *, void *);
+void slab_print_stats (void);
+
+#endif /* threads/slab.h */
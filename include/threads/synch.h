@@ -2,18 +2,53 @@
 #define THREADS_SYNCH_H
 
 #include <list.h>
+#include <pheap.h>
 #include <stdbool.h>
+#include <stdint.h>
 
-extern struct lock filesys_lock;
+struct thread;
+
+/* 락 경쟁 통계(lockstat)의 집계 단위입니다. 같은 곳에서 초기화된 락과
+   세마포어는 하나의 클래스로 묶입니다. 시간은 TSC 사이클 단위이며, 출력할 때
+   나노초로 바뀝니다. */
+/* Lock contention statistics ("lockstat") for a class of locks
+   and semaphores: those initialized at the same call site, or
+   given the same name.  Times are in TSC cycles, converted to
+   nanoseconds when printed. */
+struct lock_class {
+	const char *name;           /* 초기화 위치나 이름. *//* Init site or name. */
+	uint64_t acquisitions;      /* 획득 횟수. *//* # of acquisitions. */
+	uint64_t contended;         /* 기다려야 했던 획득 횟수. *//* # that had to wait. */
+	uint64_t wait_cycles;       /* 기다린 시간의 합. *//* Total wait. */
+	uint64_t max_wait_cycles;   /* 가장 오래 기다린 시간. *//* Longest wait. */
+	uint64_t hold_cycles;       /* 보유한 시간의 합 (락만). *//* Total hold time (locks only). */
+};
+
+/* true이면 락과 세마포어가 경쟁 통계를 모읍니다.
+   커널 명령 줄 옵션 "-lockstat"에 의해 제어됩니다. */
+/* If true, locks and semaphores collect contention statistics.
+   Controlled by kernel command-line option "-lockstat". */
+extern bool lockstat_enabled;
+
+void lockstat_print_stats (void);
+
+/* 호출한 곳의 "파일:줄" 문자열. 이름 없이 초기화된 동기화 객체의 클래스 이름입니다. */
+/* "FILE:LINE" of the caller, naming the lockstat class of
+   synchronization objects initialized without a name. */
+#define SYNCH_SITE __FILE__ ":" SYNCH_STR (__LINE__)
+#define SYNCH_STR(X) SYNCH_STR_ (X)
+#define SYNCH_STR_(X) #X
 
 /* 세마포어입니다. */
 /* A counting semaphore. */
 struct semaphore {
 	unsigned value;             /* 현재 값입니다. *//* Current value. */
-	struct list waiters;        /* 대기 중인 스레드의 목록입니다. *//* List of waiting threads. */
+	struct pheap waiters;       /* 우선순위 순으로 대기 중인 스레드입니다. *//* Waiting threads, by priority. */
+	struct lock_class *class;   /* 경쟁 통계. *//* Contention statistics. */
 };
 
-void sema_init (struct semaphore *, unsigned value);
+void sema_init_named (struct semaphore *, unsigned value, const char *name);
+#define sema_init(SEMA, VALUE) sema_init_named (SEMA, VALUE, SYNCH_SITE)
 void sema_down (struct semaphore *);
 bool sema_try_down (struct semaphore *);
 void sema_up (struct semaphore *);
@@ -23,19 +58,32 @@ void sema_self_test (void);
 /* Lock. */
 struct lock {
 	struct thread *holder;      /* 잠금을 보유한 스레드입니다 (디버깅 용). *//* Thread holding lock (for debugging). */
-	struct semaphore semaphore; /* 접근을 제어하는 이진 세마포어입니다. *//* Binary semaphore controlling access. */
+	volatile uintptr_t owner;   /* 보유 스레드 | LOCK_WAITERS. *//* Owning thread | LOCK_WAITERS. */
+	struct pheap waiters;       /* 우선순위 순으로 대기 중인 스레드입니다. *//* Waiting threads, by priority. */
+	struct list_elem held_elem; /* 보유자의 held_locks 요소. *//* In holder's held_locks while waited on. */
+	int donated_tickets;        /* 대기자들의 티켓 합. *//* Sum of waiters' tickets (stride). */
+	struct lock_class *class;   /* 경쟁 통계. *//* Contention statistics. */
+	uint64_t acquired_tsc;      /* 획득한 시각 (lockstat). *//* When acquired, for lockstat. */
 };
 
-void lock_init (struct lock *);
+/* OWNER에 함께 기록되는, 기다리는 스레드가 있다는 표시입니다.
+   스레드 구조체는 페이지 정렬되어 있으므로 최하위 비트는 항상 비어 있습니다. */
+/* Set in `owner' while threads wait for the lock.  Threads are
+   page-aligned, so the low bit of a thread pointer is free. */
+#define LOCK_WAITERS ((uintptr_t) 1)
+
+void lock_init_named (struct lock *, const char *name);
+#define lock_init(LOCK) lock_init_named (LOCK, SYNCH_SITE)
 void lock_acquire (struct lock *);
 bool lock_try_acquire (struct lock *);
 void lock_release (struct lock *);
 bool lock_held_by_current_thread (const struct lock *);
+struct thread *lock_owner (const struct lock *);
 
 /* 조건 변수입니다. */
 /* Condition variable. */
 struct condition {
-	struct list waiters;        /* 대기 중인 스레드의 목록입니다. *//* List of waiting threads. */
+	struct pheap waiters;       /* 우선순위 순으로 대기 중인 스레드입니다. *//* Waiting threads, by priority. */
 };
 
 void cond_init (struct condition *);
@@ -43,8 +91,28 @@ void cond_wait (struct condition *, struct lock *);
 void cond_signal (struct condition *, struct lock *);
 void cond_broadcast (struct condition *, struct lock *);
 
-/* 우선순위 비교 함수 */
-bool sema_compare_priority (struct list_elem *e1, struct list_elem *e2, void *aux);
+/* 읽기-쓰기 락입니다. 여러 읽기 스레드가 함께 보유하거나, 쓰기 스레드 하나가 홀로
+   보유할 수 있습니다. 기다리는 쓰기 스레드가 있으면 새 읽기 스레드는 기다립니다. */
+/* Reader-writer lock.  Held either by any number of readers at
+   once or by a single writer.  New readers wait while a writer
+   is waiting, so that writers are not starved. */
+struct rwlock {
+	struct lock lock;           /* 아래 필드를 보호합니다. *//* Protects the fields below. */
+	struct condition can_read;  /* 읽기 스레드가 들어갈 수 있을 때. *//* Readers may proceed. */
+	struct condition can_write; /* 쓰기 스레드가 들어갈 수 있을 때. *//* A writer may proceed. */
+	int readers;                /* 보유 중인 읽기 스레드 수. *//* Readers holding the lock. */
+	int waiting_writers;        /* 기다리는 쓰기 스레드 수. *//* Writers waiting for it. */
+	bool writer;                /* 쓰기 스레드가 보유 중인가? *//* Held by a writer? */
+};
+
+void rw_init_named (struct rwlock *, const char *name);
+#define rw_init(RW) rw_init_named (RW, SYNCH_SITE)
+void rw_read_acquire (struct rwlock *);
+void rw_read_release (struct rwlock *);
+void rw_write_acquire (struct rwlock *);
+void rw_write_release (struct rwlock *);
+
+void synch_priority_changed (struct thread *);
 
 /* 최적화 바리어입니다.
  *
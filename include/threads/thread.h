@@ -4,9 +4,14 @@
 
 #include <debug.h>
 #include <list.h>
+#include <pheap.h>
+#include <rbtree.h>
 #include <stdint.h>
 #include "threads/synch.h"
 #include "threads/interrupt.h"
+#include "threads/fixed-point.h"
+#include "threads/malloc.h"
+#include "devices/timer.h"
 
 // project2 syscall fdt
 // #define FDT_PAGES 3
@@ -37,6 +42,12 @@ typedef int tid_t;
 #define PRI_DEFAULT 31                  /* 기본 우선순위. *//* Default priority. */
 #define PRI_MAX 63                       /* 최대 우선순위. *//* Highest priority. */
 
+/* 보폭 스케줄러의 티켓 수. */
+/* Stride scheduler tickets. */
+#define TICKETS_MIN 1                   /* 최소 티켓 수. *//* Fewest tickets. */
+#define TICKETS_DEFAULT 100             /* 기본 티켓 수. *//* Default tickets. */
+#define TICKETS_MAX 10000               /* 최대 티켓 수. *//* Most tickets. */
+
 
 /* 커널 스레드 또는 유저 프로세스의 구조체입니다.
  *
@@ -151,12 +162,46 @@ struct thread {
 	int init_priority;
 	
 	struct lock *wait_on_lock;
-	struct list donations;
-	struct list_elem donation_elem;
+	struct list held_locks;             /* Held locks that have waiters. */
+
+	/* synch.c의 대기 큐. *//* Wait queues, owned by synch.c. */
+	struct pheap_elem wait_elem;        /* Element in a wait queue. */
+	struct pheap *wait_queue;           /* Wait queue it is in, or NULL. */
+	uint64_t wait_seq;                  /* FIFO order among equal priorities. */
+	bool wait_signaled;                 /* Woken by cond_signal()? */
+
+	/* 다중 수준 피드백 큐 스케줄러. *//* Multi-level feedback queue scheduler. */
+	int nice;                           /* Niceness, -20 to 20. */
+	fixed_t recent_cpu;                 /* Recent CPU time, 17.14. */
+	struct list_elem all_elem;          /* Element in all_list. */
+
+	/* 완전 공정 스케줄러. *//* Completely fair scheduler. */
+	int64_t vruntime;                   /* Weighted virtual runtime. */
+	struct rb_elem tree_elem;           /* Element in the EDF, CFS or stride ready tree. */
+
+	/* 보폭(stride) 스케줄러. *//* Stride scheduler. */
+	int tickets;                        /* Tickets, including donations. */
+	int init_tickets;                   /* Tickets before donation. */
+	int64_t pass;                       /* Virtual time of the next quantum. */
+
+	/* 최단 마감 우선(EDF) 실시간 클래스. *//* Earliest-deadline-first class. */
+	bool edf;                           /* In the EDF class? */
+	bool edf_waiting;                   /* Waiting for the next release? */
+	int edf_density;                    /* Admitted runtime / deadline, in 1/1000. */
+	int edf_misses;                     /* Deadlines missed. */
+	int64_t edf_runtime;                /* CPU budget per period, in ticks. */
+	int64_t edf_period;                 /* Release period, in ticks. */
+	int64_t edf_deadline;               /* Deadline relative to release. */
+	int64_t edf_abs_deadline;           /* Current job's absolute deadline. */
+	int64_t edf_budget;                 /* Budget left in this period. */
+	struct timer_callout edf_callout;   /* Releases the next job. */
 
 	/* Shared between thread.c and synch.c. */
 	struct list_elem elem;              /* 리스트 요소. *//* List element. */
-	int64_t wakeup_ticks;
+	struct timer_callout sleep_callout; /* 잠에서 깨우는 콜아웃. *//* Wakes the thread from timer_sleep(). */
+
+	/* malloc.c의 블록 매거진. *//* Block magazines, owned by malloc.c. */
+	struct magazine mags[MAG_CLASS_CNT];
 
 	// project 2: fdt
 	struct file **fdt; 
@@ -187,7 +232,8 @@ struct thread {
 #endif
 
 	/* Owned by thread.c. */
-	struct intr_frame tf;               /* 문맥 교환을 위한 정보 *//* Information for switching */
+	struct intr_frame tf;               /* 첫 진입을 위한 정보 *//* Initial state, entered by iretq. */
+	uint64_t switch_rsp;                /* thread_switch()가 저장한 rsp *//* rsp saved by thread_switch(). */
 	unsigned magic;                     /* 스택 오버플로우 감지. *//* Detects stack overflow. */
 };
 
@@ -199,14 +245,26 @@ struct thread {
    Controlled by kernel command-line option "-o mlfqs". */
 extern bool thread_mlfqs;
 
+/* true인 경우, 가상 실행 시간 기반의 완전 공정 스케줄러를 사용합니다.
+   커널 명령 줄 옵션 "-cfs"에 의해 제어됩니다. */
+/* If true, use the completely fair (virtual runtime) scheduler.
+   Controlled by kernel command-line option "-cfs". */
+extern bool thread_cfs;
+
+/* true인 경우, 티켓 비율로 CPU를 나누는 보폭 스케줄러를 사용합니다.
+   커널 명령 줄 옵션 "-stride"에 의해 제어됩니다. */
+/* If true, use the stride scheduler, which shares the CPU in
+   proportion to tickets.
+   Controlled by kernel command-line option "-stride". */
+extern bool thread_stride;
+
 void thread_init (void);
 void thread_start (void);
 
-void thread_sleep(int64_t ticks) ;
-void next_awake_ticks(int64_t ticks);
-void thread_wakeup(int64_t ticks);
+void thread_sleep (int64_t ticks);
 
 void thread_tick (void);
+void thread_idle_tick (void);
 void thread_print_stats (void);
 
 typedef void thread_func (void *aux);
@@ -225,14 +283,21 @@ void thread_yield (void);
 int thread_get_priority (void);
 void thread_set_priority (int);
 
-bool less_priority(struct list_elem *e1, struct list_elem *e2, void *aux);
-bool more_priority(struct list_elem *e1, struct list_elem *e2, void *aux);
 void test_max_priority(void);
 
-// donation 우선순위 비교
-bool thread_compare_donate_priority(struct list_elem *e1, struct list_elem *e2, void *aux);
+// 우선순위 기부
 void donate_priority(void);
-void remove_with_lock(struct lock *lock);
+void donate_handoff(struct lock *lock, struct thread *next);
+
+void thread_free_fdt (struct file **);
+
+void thread_set_tickets (int);
+int thread_get_tickets (void);
+
+bool thread_set_edf (int64_t runtime, int64_t period, int64_t deadline);
+void thread_clear_edf (void);
+void thread_edf_wait_period (void);
+int thread_edf_misses (void);
 
 int thread_get_nice (void);
 void thread_set_nice (int);
@@ -0,0 +1,65 @@
+#ifndef THREADS_TRACE_H
+#define THREADS_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* 커널 이벤트 추적입니다.
+   "-trace" 옵션을 주면 정적 추적점(TRACE)이 부팅마다 하나씩 있는 링 버퍼에
+   타임스탬프가 찍힌 고정 크기 레코드를 남깁니다. 버퍼가 차면 가장 오래된
+   레코드부터 덮어씁니다. "trace" 작업이 버퍼를 시리얼 포트로 출력합니다. */
+/* Kernel event tracing.
+   With "-trace", static tracepoints (TRACE) append fixed-size,
+   timestamped records to a ring buffer allocated once per boot,
+   overwriting the oldest records when it is full.  The "trace"
+   action dumps the buffer over the console for offline
+   analysis. */
+
+/* 추적 이벤트 종류. */
+/* Kinds of traced events. */
+enum trace_event {
+	TRACE_SWITCH,               /* Context switch: prev tid, next tid. */
+	TRACE_PAGE_FAULT,           /* Page fault: address, TRACE_PF_* bits. */
+	TRACE_SYSCALL,              /* System call: number, first argument. */
+	TRACE_DISK_READ,            /* Disk read: disk, sector. */
+	TRACE_DISK_WRITE,           /* Disk write: disk, sector. */
+	TRACE_PALLOC,               /* Page allocation: page count, address. */
+	TRACE_EVENT_CNT
+};
+
+/* TRACE_PAGE_FAULT의 두 번째 인자. */
+/* Second argument of TRACE_PAGE_FAULT. */
+#define TRACE_PF_USER 0x1           /* Fault in user mode. */
+#define TRACE_PF_WRITE 0x2          /* Write access. */
+#define TRACE_PF_NOT_PRESENT 0x4    /* Page not present. */
+
+/* 추적 레코드 하나. */
+/* One trace record. */
+struct trace_record {
+	int64_t ns;                 /* timer_ns() 시각. *//* Time, from timer_ns(). */
+	uint64_t arg0;              /* 이벤트별 인자. *//* Event-specific arguments. */
+	uint64_t arg1;
+	uint32_t seq;               /* 쓰기가 끝난 레코드의 일련번호. *//* Sequence number, stored last. */
+	uint32_t tid;               /* 실행 중이던 스레드. *//* Running thread. */
+	uint32_t event;             /* enum trace_event. */
+};
+
+extern bool trace_requested;
+extern bool trace_enabled;
+
+void trace_init (void);
+void trace_log (enum trace_event, uint64_t arg0, uint64_t arg1);
+void trace_dump (void);
+
+/* 추적이 켜져 있으면 EVENT를 기록합니다. 꺼져 있을 때는 불린 하나를 읽는
+   비용만 듭니다. */
+/* Records EVENT with arguments ARG0 and ARG1 if tracing is on.
+   Costs only a load and a branch when it is off. */
+#define TRACE(EVENT, ARG0, ARG1)                                      \
+	do {                                                          \
+		if (trace_enabled)                                    \
+			trace_log (EVENT, (uint64_t) (ARG0),       \
+					(uint64_t) (ARG1));           \
+	} while (0)
+
+#endif /* threads/trace.h */
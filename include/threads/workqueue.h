@@ -0,0 +1,46 @@
+#ifndef THREADS_WORKQUEUE_H
+#define THREADS_WORKQUEUE_H
+
+#include <list.h>
+#include <stdbool.h>
+#include "threads/synch.h"
+
+/* 작업 큐입니다.
+   인터럽트 핸들러는 급하지 않은 일을 work로 만들어 큐에 넣고, 큐의 전용 커널
+   스레드(워커)가 인터럽트가 켜진 상태에서 이를 실행합니다. */
+/* Work queues.
+   An interrupt handler packages work that need not happen at
+   once as a `struct work' and schedules it; a dedicated kernel
+   thread, the queue's worker, later runs it with interrupts on.
+   Scheduling is cheap and may be done from interrupt context. */
+
+/* 워커가 호출하는 함수입니다. */
+/* Function run by a worker. */
+typedef void work_func (void *aux);
+
+/* 지연된 작업 하나. */
+/* One piece of deferred work. */
+struct work {
+	struct list_elem elem;      /* 큐의 works 요소. *//* Element in a queue's `works'. */
+	work_func *func;            /* 실행할 함수. *//* Function to run. */
+	void *aux;                  /* FUNC의 인자. *//* Argument to FUNC. */
+	bool pending;               /* 큐에서 기다리는 중인가? *//* Queued but not yet started? */
+};
+
+/* 작업 큐. */
+/* Work queue. */
+struct workqueue {
+	const char *name;           /* 이름 (디버깅 용). *//* Name (for debugging). */
+	struct list works;          /* 기다리는 작업, 먼저 온 순서. 인터럽트를 끄고 접근합니다. *//* Pending work, FIFO; interrupts off to access. */
+	struct semaphore work_cnt;  /* WORKS의 길이. *//* Length of `works'. */
+};
+
+void workqueue_init (void);
+void workqueue_create (struct workqueue *, const char *name, int priority,
+		int worker_cnt);
+
+void work_init (struct work *, work_func *, void *aux);
+bool work_schedule (struct work *);
+bool workqueue_schedule (struct workqueue *, struct work *);
+
+#endif /* threads/workqueue.h */
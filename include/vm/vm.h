@@ -3,6 +3,7 @@
 #include <stdbool.h>
 #include <hash.h>
 #include "threads/palloc.h"
+#include "threads/slab.h"
 
 enum vm_type {
 	/* page not initialized */
@@ -107,6 +108,11 @@ struct page *spt_find_page (struct supplemental_page_table *spt,
 bool spt_insert_page (struct supplemental_page_table *spt, struct page *page);
 void spt_remove_page (struct supplemental_page_table *spt, struct page *page);
 
+/* Object caches for the VM's hot allocations. */
+extern struct slab_cache page_slab;       /* struct page. */
+extern struct slab_cache frame_slab;      /* struct frame. */
+extern struct slab_cache container_slab;  /* struct container (lazy-load aux). */
+
 void vm_init (void);
 bool vm_try_handle_fault (struct intr_frame *f, void *addr, bool user,
 		bool write, bool not_present);
@@ -0,0 +1,160 @@
+/* Pairing heap.
+
+   See pheap.h for basic information.  This is the classic
+   two-pass variant of Fredman, Sedgewick, Sleator and Tarjan,
+   "The pairing heap: a new form of self-adjusting heap"
+   (Algorithmica, 1986), with each element's children kept in a
+   list threaded through `sibling' and linked back through
+   `prev' so that any element can be cut out of the heap. */
+
+#include "pheap.h"
+#include "../debug.h"
+
+static struct pheap_elem *meld (struct pheap *,
+		struct pheap_elem *, struct pheap_elem *);
+static struct pheap_elem *merge_pairs (struct pheap *,
+		struct pheap_elem *);
+
+/* Initializes HEAP as an empty heap ordered by LESS, given
+   auxiliary data AUX. */
+void
+pheap_init (struct pheap *heap, pheap_less_func *less, void *aux) {
+	ASSERT (heap != NULL);
+	ASSERT (less != NULL);
+
+	heap->root = NULL;
+	heap->elem_cnt = 0;
+	heap->less = less;
+	heap->aux = aux;
+}
+
+/* Inserts ELEM into HEAP. */
+void
+pheap_insert (struct pheap *heap, struct pheap_elem *elem) {
+	ASSERT (heap != NULL);
+	ASSERT (elem != NULL);
+
+	elem->prev = elem->child = elem->sibling = NULL;
+	heap->root = heap->root != NULL ? meld (heap, heap->root, elem) : elem;
+	heap->elem_cnt++;
+}
+
+/* Removes ELEM, which must be in HEAP. */
+void
+pheap_remove (struct pheap *heap, struct pheap_elem *elem) {
+	struct pheap_elem *sub;
+
+	ASSERT (heap != NULL);
+	ASSERT (elem != NULL);
+	ASSERT (heap->elem_cnt > 0);
+
+	if (elem == heap->root) {
+		pheap_pop (heap);
+		return;
+	}
+
+	/* Cut ELEM, with its subtree, out of its parent's child list. */
+	if (elem->prev->child == elem)
+		elem->prev->child = elem->sibling;
+	else
+		elem->prev->sibling = elem->sibling;
+	if (elem->sibling != NULL)
+		elem->sibling->prev = elem->prev;
+
+	sub = merge_pairs (heap, elem->child);
+	if (sub != NULL)
+		heap->root = meld (heap, heap->root, sub);
+	heap->elem_cnt--;
+}
+
+/* Removes and returns the least element of HEAP, or returns a
+   null pointer if HEAP is empty. */
+struct pheap_elem *
+pheap_pop (struct pheap *heap) {
+	struct pheap_elem *top;
+
+	ASSERT (heap != NULL);
+
+	top = heap->root;
+	if (top != NULL) {
+		heap->root = merge_pairs (heap, top->child);
+		heap->elem_cnt--;
+	}
+	return top;
+}
+
+/* Returns the least element of HEAP without removing it, or a
+   null pointer if HEAP is empty. */
+struct pheap_elem *
+pheap_top (struct pheap *heap) {
+	ASSERT (heap != NULL);
+	return heap->root;
+}
+
+/* Returns true if HEAP contains no elements. */
+bool
+pheap_empty (struct pheap *heap) {
+	ASSERT (heap != NULL);
+	return heap->root == NULL;
+}
+
+/* Melds the heaps rooted at A and B, which must both be roots
+   without siblings, and returns the root of the result. */
+static struct pheap_elem *
+meld (struct pheap *heap, struct pheap_elem *a, struct pheap_elem *b) {
+	if (heap->less (b, a, heap->aux)) {
+		struct pheap_elem *t = a;
+		a = b;
+		b = t;
+	}
+
+	/* B becomes A's leftmost child. */
+	b->prev = a;
+	b->sibling = a->child;
+	if (a->child != NULL)
+		a->child->prev = b;
+	a->child = b;
+	a->prev = a->sibling = NULL;
+	return a;
+}
+
+/* Melds the list of sibling subtrees starting at FIRST into a
+   single heap and returns its root, or a null pointer if FIRST
+   is null.  First melds the subtrees in pairs from left to
+   right, then melds the pairs into one heap from right to
+   left. */
+static struct pheap_elem *
+merge_pairs (struct pheap *heap, struct pheap_elem *first) {
+	struct pheap_elem *pairs = NULL;
+	struct pheap_elem *root = NULL;
+
+	/* First pass: meld pairs, stacking the results in PAIRS so
+	   that the rightmost pair ends up on top. */
+	while (first != NULL) {
+		struct pheap_elem *a = first;
+		struct pheap_elem *b = a->sibling;
+		struct pheap_elem *merged;
+
+		if (b != NULL) {
+			first = b->sibling;
+			a->sibling = b->sibling = NULL;
+			merged = meld (heap, a, b);
+		} else {
+			first = NULL;
+			a->prev = a->sibling = NULL;
+			merged = a;
+		}
+		merged->sibling = pairs;
+		pairs = merged;
+	}
+
+	/* Second pass: meld the pairs from right to left. */
+	while (pairs != NULL) {
+		struct pheap_elem *next = pairs->sibling;
+
+		pairs->sibling = NULL;
+		root = root != NULL ? meld (heap, root, pairs) : pairs;
+		pairs = next;
+	}
+	return root;
+}
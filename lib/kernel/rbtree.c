@@ -0,0 +1,328 @@
+/* Red-black tree.
+
+   See rbtree.h for basic information.  The balancing follows
+   the classic presentation in Cormen et al., "Introduction to
+   Algorithms", with null pointers standing in for the black
+   leaves. */
+
+#include "rbtree.h"
+#include "../debug.h"
+
+static void rotate_left (struct rb_tree *, struct rb_elem *);
+static void rotate_right (struct rb_tree *, struct rb_elem *);
+static void insert_fixup (struct rb_tree *, struct rb_elem *);
+static void remove_fixup (struct rb_tree *, struct rb_elem *,
+		struct rb_elem *parent);
+
+/* Returns true if E is a red element.  Null leaves are black. */
+static inline bool
+is_red (const struct rb_elem *e) {
+	return e != NULL && e->red;
+}
+
+/* Initializes TREE as an empty tree ordered by LESS, given
+   auxiliary data AUX. */
+void
+rb_init (struct rb_tree *tree, rb_less_func *less, void *aux) {
+	ASSERT (tree != NULL);
+	ASSERT (less != NULL);
+
+	tree->root = NULL;
+	tree->min = NULL;
+	tree->elem_cnt = 0;
+	tree->less = less;
+	tree->aux = aux;
+}
+
+/* Inserts ELEM into TREE.  ELEM goes after any elements that
+   compare equal to it. */
+void
+rb_insert (struct rb_tree *tree, struct rb_elem *elem) {
+	struct rb_elem *parent = NULL;
+	struct rb_elem **link = &tree->root;
+	bool leftmost = true;
+
+	ASSERT (tree != NULL);
+	ASSERT (elem != NULL);
+
+	while (*link != NULL) {
+		parent = *link;
+		if (tree->less (elem, parent, tree->aux))
+			link = &parent->left;
+		else {
+			link = &parent->right;
+			leftmost = false;
+		}
+	}
+
+	elem->parent = parent;
+	elem->left = elem->right = NULL;
+	elem->red = true;
+	*link = elem;
+
+	if (leftmost)
+		tree->min = elem;
+	tree->elem_cnt++;
+	insert_fixup (tree, elem);
+}
+
+/* Removes ELEM, which must be in TREE. */
+void
+rb_remove (struct rb_tree *tree, struct rb_elem *elem) {
+	struct rb_elem *child, *parent;
+	bool red;
+
+	ASSERT (tree != NULL);
+	ASSERT (elem != NULL);
+	ASSERT (tree->elem_cnt > 0);
+
+	if (tree->min == elem)
+		tree->min = rb_next (elem);
+	tree->elem_cnt--;
+
+	if (elem->left != NULL && elem->right != NULL) {
+		/* Two children: splice ELEM's successor into its place. */
+		struct rb_elem *succ = elem->right;
+
+		while (succ->left != NULL)
+			succ = succ->left;
+
+		if (elem->parent == NULL)
+			tree->root = succ;
+		else if (elem->parent->left == elem)
+			elem->parent->left = succ;
+		else
+			elem->parent->right = succ;
+
+		child = succ->right;
+		parent = succ->parent;
+		red = succ->red;
+
+		if (parent == elem)
+			parent = succ;
+		else {
+			if (child != NULL)
+				child->parent = parent;
+			parent->left = child;
+			succ->right = elem->right;
+			elem->right->parent = succ;
+		}
+
+		succ->parent = elem->parent;
+		succ->red = elem->red;
+		succ->left = elem->left;
+		elem->left->parent = succ;
+	} else {
+		child = elem->left != NULL ? elem->left : elem->right;
+		parent = elem->parent;
+		red = elem->red;
+
+		if (child != NULL)
+			child->parent = parent;
+		if (parent == NULL)
+			tree->root = child;
+		else if (parent->left == elem)
+			parent->left = child;
+		else
+			parent->right = child;
+	}
+
+	if (!red)
+		remove_fixup (tree, child, parent);
+}
+
+/* Returns the smallest element in TREE, or a null pointer if
+   TREE is empty. */
+struct rb_elem *
+rb_min (struct rb_tree *tree) {
+	ASSERT (tree != NULL);
+	return tree->min;
+}
+
+/* Returns the element that follows ELEM in its tree, or a null
+   pointer if ELEM is the largest element. */
+struct rb_elem *
+rb_next (struct rb_elem *elem) {
+	ASSERT (elem != NULL);
+
+	if (elem->right != NULL) {
+		elem = elem->right;
+		while (elem->left != NULL)
+			elem = elem->left;
+		return elem;
+	}
+	while (elem->parent != NULL && elem->parent->right == elem)
+		elem = elem->parent;
+	return elem->parent;
+}
+
+/* Returns the number of elements in TREE. */
+size_t
+rb_size (struct rb_tree *tree) {
+	ASSERT (tree != NULL);
+	return tree->elem_cnt;
+}
+
+/* Returns true if TREE contains no elements. */
+bool
+rb_empty (struct rb_tree *tree) {
+	ASSERT (tree != NULL);
+	return tree->root == NULL;
+}
+
+/* Rotates the subtree rooted at E to the left. */
+static void
+rotate_left (struct rb_tree *tree, struct rb_elem *e) {
+	struct rb_elem *right = e->right;
+
+	e->right = right->left;
+	if (right->left != NULL)
+		right->left->parent = e;
+
+	right->parent = e->parent;
+	if (e->parent == NULL)
+		tree->root = right;
+	else if (e->parent->left == e)
+		e->parent->left = right;
+	else
+		e->parent->right = right;
+
+	right->left = e;
+	e->parent = right;
+}
+
+/* Rotates the subtree rooted at E to the right. */
+static void
+rotate_right (struct rb_tree *tree, struct rb_elem *e) {
+	struct rb_elem *left = e->left;
+
+	e->left = left->right;
+	if (left->right != NULL)
+		left->right->parent = e;
+
+	left->parent = e->parent;
+	if (e->parent == NULL)
+		tree->root = left;
+	else if (e->parent->right == e)
+		e->parent->right = left;
+	else
+		e->parent->left = left;
+
+	left->right = e;
+	e->parent = left;
+}
+
+/* Restores the red-black properties after inserting red
+   element E. */
+static void
+insert_fixup (struct rb_tree *tree, struct rb_elem *e) {
+	struct rb_elem *parent;
+
+	while ((parent = e->parent) != NULL && parent->red) {
+		struct rb_elem *gparent = parent->parent;
+
+		if (parent == gparent->left) {
+			struct rb_elem *uncle = gparent->right;
+
+			if (is_red (uncle)) {
+				uncle->red = parent->red = false;
+				gparent->red = true;
+				e = gparent;
+				continue;
+			}
+			if (parent->right == e) {
+				rotate_left (tree, parent);
+				e = parent;
+				parent = e->parent;
+			}
+			parent->red = false;
+			gparent->red = true;
+			rotate_right (tree, gparent);
+		} else {
+			struct rb_elem *uncle = gparent->left;
+
+			if (is_red (uncle)) {
+				uncle->red = parent->red = false;
+				gparent->red = true;
+				e = gparent;
+				continue;
+			}
+			if (parent->left == e) {
+				rotate_right (tree, parent);
+				e = parent;
+				parent = e->parent;
+			}
+			parent->red = false;
+			gparent->red = true;
+			rotate_left (tree, gparent);
+		}
+	}
+	tree->root->red = false;
+}
+
+/* Restores the red-black properties after removing a black
+   element whose place was taken by E (possibly null), now a
+   child of PARENT. */
+static void
+remove_fixup (struct rb_tree *tree, struct rb_elem *e,
+		struct rb_elem *parent) {
+	while (e != tree->root && !is_red (e)) {
+		if (parent->left == e) {
+			struct rb_elem *sibling = parent->right;
+
+			if (is_red (sibling)) {
+				sibling->red = false;
+				parent->red = true;
+				rotate_left (tree, parent);
+				sibling = parent->right;
+			}
+			if (!is_red (sibling->left) && !is_red (sibling->right)) {
+				sibling->red = true;
+				e = parent;
+				parent = e->parent;
+			} else {
+				if (!is_red (sibling->right)) {
+					sibling->left->red = false;
+					sibling->red = true;
+					rotate_right (tree, sibling);
+					sibling = parent->right;
+				}
+				sibling->red = parent->red;
+				parent->red = false;
+				sibling->right->red = false;
+				rotate_left (tree, parent);
+				e = tree->root;
+				break;
+			}
+		} else {
+			struct rb_elem *sibling = parent->left;
+
+			if (is_red (sibling)) {
+				sibling->red = false;
+				parent->red = true;
+				rotate_right (tree, parent);
+				sibling = parent->left;
+			}
+			if (!is_red (sibling->left) && !is_red (sibling->right)) {
+				sibling->red = true;
+				e = parent;
+				parent = e->parent;
+			} else {
+				if (!is_red (sibling->left)) {
+					sibling->right->red = false;
+					sibling->red = true;
+					rotate_left (tree, sibling);
+					sibling = parent->left;
+				}
+				sibling->red = parent->red;
+				parent->red = false;
+				sibling->left->red = false;
+				rotate_right (tree, parent);
+				e = tree->root;
+				break;
+			}
+		}
+	}
+	if (e != NULL)
+		e->red = false;
+}
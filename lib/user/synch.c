@@ -0,0 +1,94 @@
+#include <synch.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <syscall.h>
+
+/* Mutex states. */
+#define MUTEX_FREE 0            /* Not held. */
+#define MUTEX_HELD 1            /* Held, no waiters. */
+#define MUTEX_CONTENDED 2       /* Held, and there may be waiters. */
+
+/* Initializes mutex M as free. */
+void
+mutex_init (struct mutex *m) {
+	m->state = MUTEX_FREE;
+}
+
+/* Acquires M, sleeping in the kernel until it is free if
+   necessary.  A thread that has to wait marks M contended, so
+   that the eventual unlock knows to issue a wake-up; unlocking an
+   uncontended mutex never enters the kernel. */
+void
+mutex_lock (struct mutex *m) {
+	int state = MUTEX_FREE;
+
+	if (__atomic_compare_exchange_n (&m->state, &state, MUTEX_HELD, false,
+				__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		return;
+
+	if (state != MUTEX_CONTENDED)
+		state = __atomic_exchange_n (&m->state, MUTEX_CONTENDED, __ATOMIC_ACQUIRE);
+	while (state != MUTEX_FREE) {
+		futex_wait (&m->state, MUTEX_CONTENDED);
+		state = __atomic_exchange_n (&m->state, MUTEX_CONTENDED, __ATOMIC_ACQUIRE);
+	}
+}
+
+/* Acquires M if it is free.  Returns true if successful, false
+   if M is already held. */
+bool
+mutex_trylock (struct mutex *m) {
+	int state = MUTEX_FREE;
+
+	return __atomic_compare_exchange_n (&m->state, &state, MUTEX_HELD, false,
+			__ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+/* Releases M, which the caller must hold, waking one waiter if
+   M was contended. */
+void
+mutex_unlock (struct mutex *m) {
+	if (__atomic_exchange_n (&m->state, MUTEX_FREE, __ATOMIC_RELEASE)
+			== MUTEX_CONTENDED)
+		futex_wake (&m->state, 1);
+}
+
+/* Initializes condition variable CV. */
+void
+condvar_init (struct condvar *cv) {
+	cv->seq = 0;
+}
+
+/* Atomically releases M and waits for CV to be signaled, then
+   reacquires M before returning.  M must be held.  As with
+   Mesa-style monitors in the kernel, the caller must recheck its
+   condition after waking: wake-ups may be spurious. */
+void
+condvar_wait (struct condvar *cv, struct mutex *m) {
+	int seq = __atomic_load_n (&cv->seq, __ATOMIC_RELAXED);
+
+	/* A signal between the unlock and the wait changes SEQ, so
+	   futex_wait() returns at once rather than missing it. */
+	mutex_unlock (m);
+	futex_wait (&cv->seq, seq);
+
+	/* Other waiters may have been woken too, so take M the
+	   contended way to make sure its unlock wakes them. */
+	while (__atomic_exchange_n (&m->state, MUTEX_CONTENDED, __ATOMIC_ACQUIRE)
+			!= MUTEX_FREE)
+		futex_wait (&m->state, MUTEX_CONTENDED);
+}
+
+/* Wakes one thread waiting on CV, if any. */
+void
+condvar_signal (struct condvar *cv) {
+	__atomic_fetch_add (&cv->seq, 1, __ATOMIC_RELAXED);
+	futex_wake (&cv->seq, 1);
+}
+
+/* Wakes every thread waiting on CV. */
+void
+condvar_broadcast (struct condvar *cv) {
+	__atomic_fetch_add (&cv->seq, 1, __ATOMIC_RELAXED);
+	futex_wake (&cv->seq, INT_MAX);
+}
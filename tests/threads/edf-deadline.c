@@ -0,0 +1,113 @@
+/* Measures deadline misses of an earliest-deadline-first thread
+   under background load.
+
+   Four CPU-bound threads run at PRI_MAX for the whole test, which
+   would starve any normal thread.  An EDF thread with a 2-tick
+   budget every 10 ticks runs 50 jobs of about one tick of
+   computation each.  It should miss no deadlines, because EDF
+   threads preempt every normal thread when their job is
+   released.
+
+   Also checks admission control: a second reservation that would
+   overcommit the CPU must be refused. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "devices/timer.h"
+
+#define LOAD_THREAD_CNT 4
+#define JOB_CNT 50
+#define EDF_RUNTIME 2
+#define EDF_PERIOD 10
+
+static thread_func load_thread;
+static thread_func edf_thread;
+
+static volatile bool done;
+
+struct edf_result
+  {
+    struct semaphore finished;
+    int misses;
+    int64_t max_lateness;
+    bool overcommit_refused;
+  };
+
+void
+test_edf_deadline (void) 
+{
+  struct edf_result result;
+  int i;
+
+  /* This test does not work with the MLFQS. */
+  ASSERT (!thread_mlfqs);
+
+  sema_init (&result.finished, 0);
+  done = false;
+
+  /* Run at the load threads' priority so that creating them does
+     not preempt us before the EDF thread exists. */
+  thread_set_priority (PRI_MAX);
+  for (i = 0; i < LOAD_THREAD_CNT; i++) 
+    {
+      char name[16];
+      snprintf (name, sizeof name, "load %d", i);
+      thread_create (name, PRI_MAX, load_thread, NULL);
+    }
+  thread_create ("edf", PRI_MAX, edf_thread, &result);
+
+  sema_down (&result.finished);
+  thread_set_priority (PRI_DEFAULT);
+
+  msg ("Overcommitted reservation %s.",
+       result.overcommit_refused ? "refused" : "admitted");
+  msg ("%d jobs, %d deadline misses, max lateness %lld ticks.",
+       JOB_CNT, result.misses, result.max_lateness);
+}
+
+static void
+load_thread (void *aux UNUSED) 
+{
+  while (!done)
+    continue;
+}
+
+static void
+edf_thread (void *result_) 
+{
+  struct edf_result *result = result_;
+  int64_t release;
+  int job;
+
+  if (!thread_set_edf (EDF_RUNTIME, EDF_PERIOD, EDF_PERIOD))
+    fail ("EDF reservation refused");
+  result->overcommit_refused = !thread_set_edf (EDF_PERIOD, EDF_PERIOD,
+                                                EDF_PERIOD);
+
+  result->max_lateness = 0;
+  release = timer_ticks ();
+  for (job = 0; job < JOB_CNT; job++) 
+    {
+      /* About one tick of computation. */
+      int64_t start = timer_ticks ();
+      int64_t lateness;
+
+      while (timer_ticks () == start)
+        continue;
+
+      lateness = timer_ticks () - (release + EDF_PERIOD);
+      if (lateness > result->max_lateness)
+        result->max_lateness = lateness;
+
+      thread_edf_wait_period ();
+      release = timer_ticks ();
+    }
+
+  result->misses = thread_edf_misses ();
+  thread_clear_edf ();
+  done = true;
+  sema_up (&result->finished);
+}
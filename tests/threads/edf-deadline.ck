@@ -0,0 +1,11 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(edf-deadline) begin
+(edf-deadline) Overcommitted reservation refused.
+(edf-deadline) 50 jobs, 0 deadline misses, max lateness 0 ticks.
+(edf-deadline) end
+EOF
+pass;
@@ -29,6 +29,14 @@ static const struct test tests[] =
     {"priority-preempt", test_priority_preempt},
     {"priority-sema", test_priority_sema},
     {"priority-condvar", test_priority_condvar},
+    {"edf-deadline", test_edf_deadline},
+    {"stride-fair-2", test_stride_fair_2},
+    {"stride-ratio", test_stride_ratio},
+    {"thread-create-fail", test_thread_create_fail},
+    {"yield-pingpong", test_yield_pingpong},
+    {"lock-bench", test_lock_bench},
+    {"malloc-bench", test_malloc_bench},
+    {"string-bench", test_string_bench},
     {"mlfqs-load-1", test_mlfqs_load_1},
     {"mlfqs-load-60", test_mlfqs_load_60},
     {"mlfqs-load-avg", test_mlfqs_load_avg},
@@ -23,6 +23,14 @@ extern test_func test_priority_fifo;
 extern test_func test_priority_preempt;
 extern test_func test_priority_sema;
 extern test_func test_priority_condvar;
+extern test_func test_edf_deadline;
+extern test_func test_stride_fair_2;
+extern test_func test_stride_ratio;
+extern test_func test_thread_create_fail;
+extern test_func test_yield_pingpong;
+extern test_func test_lock_bench;
+extern test_func test_malloc_bench;
+extern test_func test_string_bench;
 extern test_func test_mlfqs_load_1;
 extern test_func test_mlfqs_load_60;
 extern test_func test_mlfqs_load_avg;
@@ -0,0 +1,102 @@
+/* Checks that thread_create() fails cleanly when it finds a page
+   for the new thread but none for its file descriptor table.
+
+   The main thread takes every free kernel page, then gives pages
+   back one at a time and calls thread_create() until it fails
+   each time.  Within a few rounds the thread and fd-table page
+   caches run dry and thread_create() gets a thread page but no
+   fd-table page, so the failure path has to hand the thread page
+   back.  If that page were left linked into the list of all
+   threads, recycling it would link it in twice, and the MLFQS
+   recalculation that walks the list once a second would never
+   finish, so the test runs with -mlfqs and sleeps across a few
+   seconds after recovering. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/palloc.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "devices/timer.h"
+
+/* More rounds than thread.c keeps pages cached. */
+#define ROUND_CNT 20
+
+static thread_func blocker_thread;
+static thread_func done_thread;
+static struct semaphore release;
+
+void
+test_thread_create_fail (void)
+{
+  struct semaphore done;
+  void *hoard = NULL;
+  void *page;
+  int blocker_cnt = 0;
+  int i;
+
+  ASSERT (thread_mlfqs);
+
+  sema_init (&release, 0);
+
+  /* Take every free kernel page, chaining them through their
+     first word. */
+  while ((page = palloc_get_page (0)) != NULL)
+    {
+      *(void **) page = hoard;
+      hoard = page;
+    }
+
+  /* Give one page back per round and create threads until
+     thread_create() fails again. */
+  for (i = 0; i < ROUND_CNT; i++)
+    {
+      if (hoard == NULL)
+        fail ("ran out of hoarded pages");
+      page = hoard;
+      hoard = *(void **) page;
+      palloc_free_page (page);
+
+      while (thread_create ("blocker", PRI_DEFAULT, blocker_thread, NULL)
+             != TID_ERROR)
+        blocker_cnt++;
+    }
+  msg ("thread_create() failed cleanly while out of memory.");
+
+  /* Recover: let the blockers exit and return the pages. */
+  for (i = 0; i < blocker_cnt; i++)
+    sema_up (&release);
+  while (hoard != NULL)
+    {
+      page = hoard;
+      hoard = *(void **) page;
+      palloc_free_page (page);
+    }
+  timer_sleep (3 * TIMER_FREQ);
+
+  sema_init (&done, 0);
+  for (i = 0; i < ROUND_CNT; i++)
+    {
+      if (thread_create ("done", PRI_DEFAULT, done_thread, &done)
+          == TID_ERROR)
+        fail ("thread_create() failed after memory was returned");
+      sema_down (&done);
+    }
+  timer_sleep (2 * TIMER_FREQ);
+  msg ("Threads created after recovering run normally.");
+}
+
+static void
+blocker_thread (void *aux UNUSED)
+{
+  sema_down (&release);
+}
+
+static void
+done_thread (void *done_)
+{
+  struct semaphore *done = done_;
+
+  sema_up (done);
+}
@@ -0,0 +1,11 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(thread-create-fail) begin
+(thread-create-fail) thread_create() failed cleanly while out of memory.
+(thread-create-fail) Threads created after recovering run normally.
+(thread-create-fail) end
+EOF
+pass;
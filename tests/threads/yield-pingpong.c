@@ -0,0 +1,53 @@
+/* Measures the cost of a voluntary context switch.
+
+   Two threads of equal priority call thread_yield() back and
+   forth, so every yield switches to the other thread.  Reports
+   the average nanoseconds per switch, measured with timer_ns().
+   The count varies from run to run, so this is a benchmark rather
+   than a pass/fail test and is not part of the graded set; run
+   it with "pintos -- -q run yield-pingpong". */
+
+#include <stdint.h>
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "devices/timer.h"
+#include "threads/init.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+
+#define YIELD_CNT 100000
+
+static thread_func partner_thread;
+static struct semaphore partner_done;
+
+void
+test_yield_pingpong (void) 
+{
+  int64_t start, ns;
+  int i;
+
+  /* This test does not work with the MLFQS. */
+  ASSERT (!thread_mlfqs);
+
+  sema_init (&partner_done, 0);
+  thread_create ("partner", thread_get_priority (), partner_thread, NULL);
+
+  start = timer_ns ();
+  for (i = 0; i < YIELD_CNT; i++)
+    thread_yield ();
+  sema_down (&partner_done);
+  ns = timer_ns () - start;
+
+  msg ("%d switches: %lld ns per switch.", 2 * YIELD_CNT,
+       (long long) (ns / (2 * YIELD_CNT)));
+}
+
+static void
+partner_thread (void *aux UNUSED) 
+{
+  int i;
+
+  for (i = 0; i < YIELD_CNT; i++)
+    thread_yield ();
+  sema_up (&partner_done);
+}
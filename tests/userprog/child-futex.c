@@ -0,0 +1,23 @@
+/* Child process run by futex-shared.
+   Maps "futex.dat" and sleeps on its first word until
+   futex-shared, which maps the same file, wakes it. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+
+#define ACTUAL ((void *) 0x10000000)
+
+int
+main (void) 
+{
+  int *word = ACTUAL;
+  int handle;
+
+  test_name = "child-futex";
+
+  CHECK ((handle = open ("futex.dat")) > 1, "open \"futex.dat\"");
+  CHECK (mmap (ACTUAL, sizeof *word, 0, handle, 0) != MAP_FAILED,
+         "mmap \"futex.dat\"");
+  CHECK (futex_wait (word, 0) == 0, "futex_wait until woken");
+  return 0;
+}
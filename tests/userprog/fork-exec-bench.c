@@ -0,0 +1,46 @@
+/* Measures the cost of a fork/exec/exit round trip.
+
+   Forks a child that execs child-simple, waits for it, and
+   reports the average and fastest round trip in nanoseconds, read
+   with the clock_ns() system call.  The times vary from run to
+   run, so this is a benchmark rather than a pass/fail test and
+   is not part of the graded set.  Run it by hand, for example:
+
+     pintos --fs-disk=10 -p tests/userprog/fork-exec-bench:fork-exec-bench \
+       -p tests/userprog/child-simple:child-simple -- -q -f run fork-exec-bench */
+
+#include <stdint.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define ROUND_TRIPS 32
+
+void
+test_main (void) 
+{
+  int64_t total = 0, best = INT64_MAX;
+  int i;
+
+  for (i = 0; i < ROUND_TRIPS; i++)
+    {
+      int64_t start = clock_ns ();
+      int pid;
+
+      if ((pid = fork ("child")) == 0)
+        {
+          exec ("child-simple");
+          fail ("exec failed");
+        }
+      if (wait (pid) != 81)
+        fail ("wrong exit status from child-simple");
+
+      int64_t ns = clock_ns () - start;
+      total += ns;
+      if (ns < best)
+        best = ns;
+    }
+
+  msg ("%d round trips: average %lld ns, best %lld ns",
+       ROUND_TRIPS, (long long) (total / ROUND_TRIPS), (long long) best);
+}
@@ -0,0 +1,31 @@
+/* Exercises futex_wait() and futex_wake() within one process.
+   Waiting on a word that no longer holds the expected value must
+   return at once, waking a word nobody waits on wakes no one,
+   and the lib/user mutex and condition variable must work when
+   uncontended. */
+
+#include <synch.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void) 
+{
+  static struct mutex mutex;
+  static struct condvar condvar;
+  int word = 1;
+
+  CHECK (futex_wait (&word, 0) == -1, "futex_wait on changed value");
+  CHECK (futex_wake (&word, 1) == 0, "futex_wake with no waiters");
+
+  mutex_init (&mutex);
+  condvar_init (&condvar);
+  mutex_lock (&mutex);
+  CHECK (!mutex_trylock (&mutex), "mutex_trylock on held mutex");
+  condvar_signal (&condvar);
+  condvar_broadcast (&condvar);
+  mutex_unlock (&mutex);
+  CHECK (mutex_trylock (&mutex), "mutex_trylock on free mutex");
+  mutex_unlock (&mutex);
+}
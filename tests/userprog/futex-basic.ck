@@ -0,0 +1,14 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(futex-basic) begin
+(futex-basic) futex_wait on changed value
+(futex-basic) futex_wake with no waiters
+(futex-basic) mutex_trylock on held mutex
+(futex-basic) mutex_trylock on free mutex
+(futex-basic) end
+futex-basic: exit(0)
+EOF
+pass;
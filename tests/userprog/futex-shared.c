@@ -0,0 +1,52 @@
+/* Checks that a futex on a word of a mapped file is shared
+   between processes that map the file.
+
+   Forks a child that execs child-futex, which maps "futex.dat"
+   and sleeps on its first word.  This process maps the same file
+   and calls futex_wake() on its own mapping of the word until it
+   wakes the child, giving up after WAKE_TIMEOUT_NS.  Only the
+   wake-up is shared: each process has a private copy of the
+   mapped page, so the word's value is not.
+
+   The child prints as it goes, so the output depends on
+   scheduling, and this test is not part of the graded set.  Run
+   it by hand, for example:
+
+     pintos --fs-disk=10 -p tests/userprog/futex-shared:futex-shared \
+       -p tests/userprog/child-futex:child-futex -- -q -f run futex-shared */
+
+#include <stdint.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define ACTUAL ((void *) 0x10000000)
+
+/* How long to keep trying to wake the child. */
+#define WAKE_TIMEOUT_NS (5LL * 1000 * 1000 * 1000)
+
+void
+test_main (void)
+{
+  int *shared = ACTUAL;
+  int64_t start;
+  int handle;
+  pid_t pid;
+
+  CHECK (create ("futex.dat", sizeof *shared), "create \"futex.dat\"");
+  pid = fork ("child-futex");
+  if (pid == 0)
+    {
+      exec ("child-futex");
+      fail ("exec failed");
+    }
+  CHECK ((handle = open ("futex.dat")) > 1, "open \"futex.dat\"");
+  CHECK (mmap (ACTUAL, sizeof *shared, 0, handle, 0) != MAP_FAILED,
+         "mmap \"futex.dat\"");
+
+  start = clock_ns ();
+  while (futex_wake (shared, 1) == 0)
+    if (clock_ns () - start > WAKE_TIMEOUT_NS)
+      fail ("child-futex never slept on the shared word");
+  CHECK (wait (pid) == 0, "wait for child-futex");
+}
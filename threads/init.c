@@ -21,8 +21,12 @@
 #include "threads/malloc.h"
 #include "threads/mmu.h"
 #include "threads/palloc.h"
+#include "threads/profile.h"
+#include "threads/slab.h"
 #include "threads/pte.h"
 #include "threads/thread.h"
+#include "threads/trace.h"
+#include "threads/workqueue.h"
 #ifdef USERPROG
 #include "userprog/exception.h"
 #include "userprog/gdt.h"
@@ -94,6 +98,7 @@ int main(void) {
     /* Initialize memory system. */
     mem_end = palloc_init();        // 메모리 크기 결정
     malloc_init();  
+    slab_init();
     paging_init(mem_end);           // 메모리 initialize
     
 #ifdef USERPROG
@@ -113,6 +118,9 @@ int main(void) {
     /* 스레드 스케줄러를 시작하고 인터럽트를 활성화합니다. */
     /* Start thread scheduler and enable interrupts. */
     thread_start();
+    workqueue_init();
+    trace_init();
+    profile_init();
     serial_init_queue();
     timer_calibrate();
 
@@ -246,6 +254,18 @@ static char **parse_options(char **argv) {
             random_init(atoi(value));
         else if (!strcmp(name, "-mlfqs"))  // 다중 레벨 피드백 큐 스케줄러 사용 옵션
             thread_mlfqs = true;
+        else if (!strcmp(name, "-cfs"))  // 완전 공정 스케줄러 사용 옵션
+            thread_cfs = true;
+        else if (!strcmp(name, "-stride"))  // 보폭 스케줄러 사용 옵션
+            thread_stride = true;
+        else if (!strcmp(name, "-tickless"))  // 유휴 상태에서 주기적 타이머 인터럽트 생략
+            timer_tickless = true;
+        else if (!strcmp(name, "-trace"))  // 커널 이벤트 추적 사용
+            trace_requested = true;
+        else if (!strcmp(name, "-profile"))  // 타이머 인터럽트 표본 프로파일러 사용
+            profile_enabled = true;
+        else if (!strcmp(name, "-lockstat"))  // 락 경쟁 통계 수집
+            lockstat_enabled = true;
 #ifdef USERPROG
         else if (!strcmp(name, "-ul"))  // 사용자 페이지 제한 설정
             user_page_limit = atoi(value);
@@ -256,6 +276,9 @@ static char **parse_options(char **argv) {
             PANIC("unknown option `%s' (use -h for help)", name);  // 알려지지 않은 옵션 처리
     }
 
+    if (thread_mlfqs + thread_cfs + thread_stride > 1)
+        PANIC("-mlfqs, -cfs and -stride are mutually exclusive");
+
     return argv;  // 옵션이 아닌 첫 인자를 가리키는 포인터 반환
 }
 
@@ -277,6 +300,12 @@ static void run_task(char **argv) {
     printf("Execution of '%s' complete.\n", task);
 }
 
+/* 커널 이벤트 추적 버퍼를 출력합니다. */
+/* Dumps the kernel event trace buffer. */
+static void run_trace(char **argv UNUSED) {
+    trace_dump();
+}
+
 /* 지정된 ARGV[]에 있는 모든 작업을 실행합니다.
    NULL 포인터 전까지 실행합니다. */
 /* Executes all of the actions specified in ARGV[]
@@ -293,6 +322,7 @@ static void run_actions(char **argv) {
     /* Table of supported actions. */
     static const struct action actions[] = {
         {"run", 2, run_task},
+        {"trace", 1, run_trace},
 #ifdef FILESYS
         {"ls", 1, fsutil_ls}, {"cat", 2, fsutil_cat}, {"rm", 2, fsutil_rm}, {"put", 2, fsutil_put}, {"get", 2, fsutil_get},
 #endif
@@ -338,6 +368,7 @@ static void usage(void) {
 #else
         "  run TEST           Run TEST.\n"  // 테스트 실행
 #endif
+        "  trace              Dump the kernel event trace buffer (-trace).\n"  // 이벤트 추적 버퍼 출력
 #ifdef FILESYS
         "  ls                 List files in the root directory.\n"        // 루트 디렉토리 파일 목록 표시
         "  cat FILE           Print FILE to the console.\n"               // 콘솔에 file 출력
@@ -352,6 +383,12 @@ static void usage(void) {
         "  -f                 Format file system disk during startup.\n"    // 시작 시 파일 시스템 디스크를 포맷
         "  -rs=SEED           Set random number seed to SEED.\n"            // 난수 시드를 SEED 로 설정
         "  -mlfqs             Use multi-level feedback queue scheduler.\n"  // 멀티 레벨 피드백 큐 스케줄러를 사용합니다.
+        "  -cfs               Use completely fair (vruntime) scheduler.\n"  // 완전 공정 스케줄러를 사용합니다.
+        "  -stride            Use stride (proportional-share) scheduler.\n"  // 보폭 스케줄러를 사용합니다.
+        "  -tickless          Stop the periodic timer tick while idle.\n"  // 유휴 상태에서 주기적 틱을 멈춥니다.
+        "  -trace             Record kernel events for the trace action.\n"  // trace 작업을 위해 커널 이벤트를 기록합니다.
+        "  -profile           Sample the interrupted rip on each timer tick.\n"  // 타이머 틱마다 rip 표본을 기록합니다.
+        "  -lockstat          Collect lock contention statistics.\n"  // 락 경쟁 통계를 모읍니다.
 #ifdef USERPROG
         "  -ul=COUNT          Limit user memory to COUNT pages.\n"  // 사용자 메모리를 count 페이지로 제한
 #endif
@@ -381,6 +418,10 @@ void power_off(void) {
 static void print_stats(void) {
     timer_print_stats();   // 타이머 통계
     thread_print_stats();  // 스레드 통계
+    palloc_print_stats();  // 미리 0으로 채운 페이지 적중률
+    slab_print_stats();    // 슬랩 캐시 통계
+    profile_print_stats();  // 프로파일 보고서
+    lockstat_print_stats();  // 락 경쟁 통계
 #ifdef FILESYS
     disk_print_stats();  // 디스크 통계
 #endif
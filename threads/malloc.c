@@ -7,13 +7,16 @@
 #include <string.h>
 #include "threads/palloc.h"
 #include "threads/synch.h"
+#include "threads/thread.h"
 #include "threads/vaddr.h"
 
 /* A simple implementation of malloc().
 
-   The size of each request, in bytes, is rounded up to a power
-   of 2 and assigned to the "descriptor" that manages blocks of
-   that size.  The descriptor keeps a list of free blocks.  If
+   The size of each request, in bytes, is rounded up to the
+   nearest size class and assigned to the "descriptor" that
+   manages blocks of that size.  Size classes are spaced about
+   1.25x apart, so that rounding wastes at most about a fifth of
+   a block, instead of up to half of it with powers of 2.  The descriptor keeps a list of free blocks.  If
    the free list is nonempty, one of its blocks is used to
    satisfy the request.
 
@@ -28,6 +31,13 @@
    blocks, we remove all of the arena's blocks from the free list
    and give the arena back to the page allocator.
 
+   Each thread also keeps a small "magazine" of free blocks for
+   each of the smallest size classes.  malloc() takes blocks from
+   and free() returns blocks to the running thread's magazine
+   without taking the descriptor's lock, which is only needed to
+   move half a magazine at a time to or from the free list.  A
+   thread's magazines are emptied when it exits.
+
    We can't handle blocks bigger than 2 kB using this scheme,
    because they're too big to fit in a single page with a
    descriptor.  We handle those by allocating contiguous pages
@@ -54,28 +64,65 @@ struct arena {
 
 /* Free block. */
 struct block {
-	struct list_elem free_elem; /* Free list element. */
+	union {
+		struct list_elem free_elem; /* Free list element. */
+		struct block *mag_next;     /* Next block in a magazine. */
+	};
 };
 
+/* Size classes are multiples of this many bytes. */
+#define BLOCK_ALIGN 16
+
+/* Largest size served by a descriptor: two blocks per arena. */
+#define MAX_BLOCK_SIZE \
+	((PGSIZE - sizeof (struct arena)) / 2 / BLOCK_ALIGN * BLOCK_ALIGN)
+
 /* Our set of descriptors. */
-static struct desc descs[10];   /* Descriptors. */
+static struct desc descs[20];   /* Descriptors. */
 static size_t desc_cnt;         /* Number of descriptors. */
 
+/* Index into descs[] of the descriptor for each request size,
+   indexed by (size - 1) / BLOCK_ALIGN. */
+static uint8_t size_to_desc[MAX_BLOCK_SIZE / BLOCK_ALIGN];
+
 static struct arena *block_to_arena (struct block *);
 static struct block *arena_to_block (struct arena *, size_t idx);
+static struct block *desc_get_block (struct desc *);
+static void desc_put_block (struct desc *, struct block *);
 
 /* Initializes the malloc() descriptors. */
 void
 malloc_init (void) {
-	size_t block_size;
+	size_t block_size, i;
 
-	for (block_size = 16; block_size < PGSIZE / 2; block_size *= 2) {
+	for (block_size = BLOCK_ALIGN; block_size <= MAX_BLOCK_SIZE; ) {
 		struct desc *d = &descs[desc_cnt++];
+		size_t blocks_per_arena = (PGSIZE - sizeof (struct arena)) / block_size;
+
+		/* Stretch the class to the largest size that still fits
+		   as many blocks in an arena, since the extra bytes would
+		   otherwise go unused at the end of every arena. */
+		block_size = (PGSIZE - sizeof (struct arena)) / blocks_per_arena;
+		block_size = ROUND_DOWN (block_size, BLOCK_ALIGN);
+
 		ASSERT (desc_cnt <= sizeof descs / sizeof *descs);
 		d->block_size = block_size;
-		d->blocks_per_arena = (PGSIZE - sizeof (struct arena)) / block_size;
+		d->blocks_per_arena = blocks_per_arena;
 		list_init (&d->free_list);
 		lock_init (&d->lock);
+
+		block_size = ROUND_UP (block_size * 5 / 4, BLOCK_ALIGN);
+	}
+	ASSERT (descs[desc_cnt - 1].block_size == MAX_BLOCK_SIZE);
+	ASSERT (desc_cnt >= MAG_CLASS_CNT);
+
+	for (i = 0; i < sizeof size_to_desc; i++) {
+		size_t size = (i + 1) * BLOCK_ALIGN;
+		uint8_t idx = i > 0 ? size_to_desc[i - 1] : 0;
+
+		while (descs[idx].block_size < size)
+			idx++;
+		size_to_desc[i] = idx;
 	}
 }
 
@@ -86,17 +133,13 @@ malloc (size_t size) {
 	struct desc *d;
 	struct block *b;
 	struct arena *a;
+	size_t idx;
 
 	/* A null pointer satisfies a request for 0 bytes. */
 	if (size == 0)
 		return NULL;
 
-	/* Find the smallest descriptor that satisfies a SIZE-byte
-	   request. */
-	for (d = descs; d < descs + desc_cnt; d++)
-		if (d->block_size >= size)
-			break;
-	if (d == descs + desc_cnt) {
+	if (size > MAX_BLOCK_SIZE) {
 		/* SIZE is too big for any descriptor.
 		   Allocate enough pages to hold SIZE plus an arena. */
 		size_t page_cnt = DIV_ROUND_UP (size + sizeof *a, PGSIZE);
@@ -112,7 +155,52 @@ malloc (size_t size) {
 		return a + 1;
 	}
 
+	/* Find the smallest descriptor that satisfies a SIZE-byte
+	   request. */
+	idx = size_to_desc[(size - 1) / BLOCK_ALIGN];
+	d = &descs[idx];
+
+	if (idx < MAG_CLASS_CNT) {
+		struct magazine *m = &thread_current ()->mags[idx];
+
+		/* Refill an empty magazine to half full, plus the block
+		   we return. */
+		if (m->cnt == 0) {
+			lock_acquire (&d->lock);
+			while (m->cnt < MAG_SIZE / 2) {
+				b = desc_get_block (d);
+				if (b == NULL)
+					break;
+				b->mag_next = m->blocks;
+				m->blocks = b;
+				m->cnt++;
+			}
+			lock_release (&d->lock);
+			if (m->cnt == 0)
+				return NULL;
+		}
+
+		b = m->blocks;
+		m->blocks = b->mag_next;
+		m->cnt--;
+		return b;
+	}
+
 	lock_acquire (&d->lock);
+	b = desc_get_block (d);
+	lock_release (&d->lock);
+	return b;
+}
+
+/* Removes and returns a block from D's free list, creating a new
+   arena if the list is empty.  Returns a null pointer if memory
+   is not available.  D's lock must be held. */
+static struct block *
+desc_get_block (struct desc *d) {
+	struct block *b;
+	struct arena *a;
+
+	ASSERT (lock_held_by_current_thread (&d->lock));
 
 	/* If the free list is empty, create a new arena. */
 	if (list_empty (&d->free_list)) {
@@ -120,10 +208,8 @@ malloc (size_t size) {
 
 		/* Allocate a page. */
 		a = palloc_get_page (0);
-		if (a == NULL) {
-			lock_release (&d->lock);
+		if (a == NULL)
 			return NULL;
-		}
 
 		/* Initialize arena and add its blocks to the free list. */
 		a->magic = ARENA_MAGIC;
@@ -139,7 +225,6 @@ malloc (size_t size) {
 	b = list_entry (list_pop_front (&d->free_list), struct block, free_elem);
 	a = block_to_arena (b);
 	a->free_cnt--;
-	lock_release (&d->lock);
 	return b;
 }
 
@@ -173,6 +258,13 @@ block_size (void *block) {
 	return d != NULL ? d->block_size : PGSIZE * a->free_cnt - pg_ofs (block);
 }
 
+/* Returns the number of bytes that may be used in BLOCK, which
+   must have been returned by malloc(), calloc(), or realloc(). */
+size_t
+malloc_usable_size (void *block) {
+	return block != NULL ? block_size (block) : 0;
+}
+
 /* Attempts to resize OLD_BLOCK to NEW_SIZE bytes, possibly
    moving it in the process.
    If successful, returns the new block; on failure, returns a
@@ -207,29 +299,36 @@ free (void *p) {
 
 		if (d != NULL) {
 			/* It's a normal block.  We handle it here. */
+			size_t idx = d - descs;
 
 #ifndef NDEBUG
 			/* Clear the block to help detect use-after-free bugs. */
 			memset (b, 0xcc, d->block_size);
 #endif
 
-			lock_acquire (&d->lock);
-
-			/* Add block to free list. */
-			list_push_front (&d->free_list, &b->free_elem);
-
-			/* If the arena is now entirely unused, free it. */
-			if (++a->free_cnt >= d->blocks_per_arena) {
-				size_t i;
-
-				ASSERT (a->free_cnt == d->blocks_per_arena);
-				for (i = 0; i < d->blocks_per_arena; i++) {
-					struct block *b = arena_to_block (a, i);
-					list_remove (&b->free_elem);
+			if (idx < MAG_CLASS_CNT) {
+				struct magazine *m = &thread_current ()->mags[idx];
+
+				/* Drain a full magazine to half full. */
+				if (m->cnt >= MAG_SIZE) {
+					lock_acquire (&d->lock);
+					while (m->cnt > MAG_SIZE / 2) {
+						struct block *victim = m->blocks;
+						m->blocks = victim->mag_next;
+						m->cnt--;
+						desc_put_block (d, victim);
+					}
+					lock_release (&d->lock);
 				}
-				palloc_free_page (a);
+
+				b->mag_next = m->blocks;
+				m->blocks = b;
+				m->cnt++;
+				return;
 			}
 
+			lock_acquire (&d->lock);
+			desc_put_block (d, b);
 			lock_release (&d->lock);
 		} else {
 			/* It's a big block.  Free its pages. */
@@ -239,6 +338,55 @@ free (void *p) {
 	}
 }
 
+/* Returns block B to D's free list, and its arena to the page
+   allocator if the arena is now entirely unused.  D's lock must
+   be held. */
+static void
+desc_put_block (struct desc *d, struct block *b) {
+	struct arena *a = block_to_arena (b);
+
+	ASSERT (lock_held_by_current_thread (&d->lock));
+
+	/* Add block to free list. */
+	list_push_front (&d->free_list, &b->free_elem);
+
+	/* If the arena is now entirely unused, free it. */
+	if (++a->free_cnt >= d->blocks_per_arena) {
+		size_t i;
+
+		ASSERT (a->free_cnt == d->blocks_per_arena);
+		for (i = 0; i < d->blocks_per_arena; i++) {
+			struct block *b = arena_to_block (a, i);
+			list_remove (&b->free_elem);
+		}
+		palloc_free_page (a);
+	}
+}
+
+/* Returns the blocks in the running thread's magazines to their
+   descriptors.  Called when the thread exits. */
+void
+malloc_thread_exit (void) {
+	struct thread *t = thread_current ();
+	size_t idx;
+
+	for (idx = 0; idx < MAG_CLASS_CNT; idx++) {
+		struct magazine *m = &t->mags[idx];
+		struct desc *d = &descs[idx];
+
+		if (m->cnt == 0)
+			continue;
+		lock_acquire (&d->lock);
+		while (m->blocks != NULL) {
+			struct block *b = m->blocks;
+			m->blocks = b->mag_next;
+			desc_put_block (d, b);
+		}
+		m->cnt = 0;
+		lock_release (&d->lock);
+	}
+}
+
 /* Returns the arena that block B is inside. */
 static struct arena *
 block_to_arena (struct block *b) {
@@ -2,14 +2,17 @@
 #include <bitmap.h>
 #include <debug.h>
 #include <inttypes.h>
+#include <list.h>
 #include <round.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include "threads/init.h"
+#include "threads/interrupt.h"
 #include "threads/loader.h"
 #include "threads/synch.h"
+#include "threads/trace.h"
 #include "threads/vaddr.h"
 
 /* Page allocator.  Hands out memory in page-size (or
@@ -24,13 +27,53 @@
 
    By default, half of system RAM is given to the kernel pool and
    half to the user pool.  That should be huge overkill for the
-   kernel pool, but that's just fine for demonstration purposes. */
+   kernel pool, but that's just fine for demonstration purposes.
+
+   Within a pool, free pages are managed by a binary buddy
+   allocator.  Free memory is kept as blocks of 2**K pages, each
+   aligned to a multiple of 2**K pages from the pool's base, on
+   one free list per order K.  A request for N pages takes a
+   block of the smallest order that fits, splitting larger blocks
+   in half as needed, and gives back the unused tail.  A freed
+   block is merged with its "buddy", the other half of the block
+   it was split from, for as long as the buddy is also free.
+   Both take O(log n) steps.
+
+   Free list elements are kept in a per-page array next to the
+   pool's bitmap rather than in the free pages themselves, since
+   palloc_init() runs before all of memory is mapped.
+
+   The idle thread also takes free pages out of each pool, zeroes
+   them and keeps them on a separate stack of pre-zeroed pages, so
+   that most single-page PAL_ZERO requests need no memset().  The
+   stack is linked through the first word of each page, which is
+   cleared again when the page is handed out.  If a pool runs out
+   of free blocks, its pre-zeroed pages are given back to it before
+   the request fails. */
+
+/* Largest block order: blocks of up to 2**MAX_ORDER pages. */
+#define MAX_ORDER 20
+
+/* In a pool's order_map, marks the first page of a free block.
+   The low bits give the block's order. */
+#define ORDER_FREE 0x80
+
+/* Pre-zeroed pages the idle thread keeps per pool. */
+#define ZERO_TARGET 64
 
 /* A memory pool. */
 struct pool {
-	struct lock lock;               /* Mutual exclusion. */
+	/* Interrupts are disabled while the maps and lists are changed. */
 	struct bitmap *used_map;        /* Bitmap of free pages. */
+	uint8_t *order_map;             /* Per-page free block orders. */
+	struct list_elem *links;        /* Per-page free list elements. */
+	struct list free_lists[MAX_ORDER + 1]; /* Free blocks by order. */
 	uint8_t *base;                  /* Base of pool. */
+
+	void *zero_top;                 /* Stack of pre-zeroed pages. */
+	size_t zero_cnt;                /* Pages on the stack. */
+	unsigned long long zero_hits;   /* PAL_ZERO pages taken from the stack. */
+	unsigned long long zero_misses; /* PAL_ZERO pages zeroed on demand. */
 };
 
 /* Two pools: one for kernel data, one for user pages. */
@@ -42,6 +85,11 @@ static void
 init_pool (struct pool *p, void **bm_base, uint64_t start, uint64_t end);
 
 static bool page_from_pool (const struct pool *, void *page);
+static size_t pool_alloc (struct pool *, size_t page_cnt);
+static void pool_free (struct pool *, size_t page_idx, size_t page_cnt);
+static void *zero_get (struct pool *);
+static bool zero_drain (struct pool *);
+static bool zero_one (struct pool *);
 
 /* multiboot info */
 struct multiboot_info {
@@ -223,12 +271,12 @@ split:
 			page_idx = pg_no (start) - pg_no (pool->base);
 			if ((uint64_t) pool_end < end) {
 				page_cnt = ((uint64_t) pool_end - start) / PGSIZE;
-				bitmap_set_multiple (pool->used_map, page_idx, page_cnt, false);
+				pool_free (pool, page_idx, page_cnt);
 				start = (uint64_t) pool_end;
 				goto split;
 			} else {
 				page_cnt = ((uint64_t) end - start) / PGSIZE;
-				bitmap_set_multiple (pool->used_map, page_idx, page_cnt, false);
+				pool_free (pool, page_idx, page_cnt);
 			}
 		}
 	}
@@ -262,25 +310,31 @@ palloc_init (void) {
 void *
 palloc_get_multiple (enum palloc_flags flags, size_t page_cnt) {
 	struct pool *pool = flags & PAL_USER ? &user_pool : &kernel_pool;
-
-	lock_acquire (&pool->lock);
-	size_t page_idx = bitmap_scan_and_flip (pool->used_map, 0, page_cnt, false);
-	lock_release (&pool->lock);
-	void *pages;
-
-	if (page_idx != BITMAP_ERROR)
-		pages = pool->base + PGSIZE * page_idx;
-	else
-		pages = NULL;
-
-	if (pages) {
-		if (flags & PAL_ZERO)
-			memset (pages, 0, PGSIZE * page_cnt);
-	} else {
-		if (flags & PAL_ASSERT)
+	enum intr_level old_level;
+	void *pages = NULL;
+
+	if (page_cnt == 0)
+		return NULL;
+
+	if ((flags & PAL_ZERO) && page_cnt == 1)
+		pages = zero_get (pool);
+
+	if (pages == NULL) {
+		old_level = intr_disable ();
+		size_t page_idx = pool_alloc (pool, page_cnt);
+		if (page_idx == BITMAP_ERROR && zero_drain (pool))
+			page_idx = pool_alloc (pool, page_cnt);
+		intr_set_level (old_level);
+
+		if (page_idx != BITMAP_ERROR) {
+			pages = pool->base + PGSIZE * page_idx;
+			if (flags & PAL_ZERO)
+				memset (pages, 0, PGSIZE * page_cnt);
+		} else if (flags & PAL_ASSERT)
 			PANIC ("palloc_get: out of pages");
 	}
 
+	TRACE (TRACE_PALLOC, page_cnt, pages);
 	return pages;
 }
 
@@ -296,10 +350,15 @@ palloc_get_page (enum palloc_flags flags) {
 	return palloc_get_multiple (flags, 1);
 }
 
-/* Frees the PAGE_CNT pages starting at PAGES. */
+/* Frees the PAGE_CNT pages starting at PAGES.
+
+   The pool is changed with interrupts off rather than under a
+   lock, because the scheduler frees dying threads' pages with
+   interrupts already off and must not sleep. */
 void
 palloc_free_multiple (void *pages, size_t page_cnt) {
 	struct pool *pool;
+	enum intr_level old_level;
 	size_t page_idx;
 
 	ASSERT (pg_ofs (pages) == 0);
@@ -318,8 +377,9 @@ palloc_free_multiple (void *pages, size_t page_cnt) {
 #ifndef NDEBUG
 	memset (pages, 0xcc, PGSIZE * page_cnt);
 #endif
-	ASSERT (bitmap_all (pool->used_map, page_idx, page_cnt));
-	bitmap_set_multiple (pool->used_map, page_idx, page_cnt, false);
+	old_level = intr_disable ();
+	pool_free (pool, page_idx, page_cnt);
+	intr_set_level (old_level);
 }
 
 /* Frees the page at PAGE. */
@@ -328,23 +388,141 @@ palloc_free_page (void *page) {
 	palloc_free_multiple (page, 1);
 }
 
-/* Initializes pool P as starting at START and ending at END */
+/* Zeroes one free page for the pre-zeroed stack of a pool that
+   is below its target.  Returns true if a page was zeroed, false
+   if there was nothing to do.  Called by the idle thread. */
+bool
+palloc_zero_idle (void) {
+	return zero_one (&kernel_pool) || zero_one (&user_pool);
+}
+
+/* Prints how often PAL_ZERO requests found a pre-zeroed page. */
+void
+palloc_print_stats (void) {
+	unsigned long long hits = kernel_pool.zero_hits + user_pool.zero_hits;
+	unsigned long long misses = kernel_pool.zero_misses + user_pool.zero_misses;
+
+	printf ("Palloc: %llu of %llu PAL_ZERO pages served pre-zeroed\n",
+			hits, hits + misses);
+}
+
+/* Initializes pool P as starting at START and ending at END. */
 static void
 init_pool (struct pool *p, void **bm_base, uint64_t start, uint64_t end) {
-  /* We'll put the pool's used_map at its base.
-     Calculate the space needed for the bitmap
-     and subtract it from the pool's size. */
+  /* We'll put the pool's used_map, order_map and free list
+     elements at *BM_BASE.  Calculate the space needed for
+     each and advance *BM_BASE past them. */
 	uint64_t pgcnt = (end - start) / PGSIZE;
 	size_t bm_pages = DIV_ROUND_UP (bitmap_buf_size (pgcnt), PGSIZE) * PGSIZE;
+	size_t om_pages = DIV_ROUND_UP (pgcnt, PGSIZE) * PGSIZE;
+	size_t ln_pages = DIV_ROUND_UP (pgcnt * sizeof (struct list_elem), PGSIZE)
+		* PGSIZE;
+	int order;
 
-	lock_init(&p->lock);
 	p->used_map = bitmap_create_in_buf (pgcnt, *bm_base, bm_pages);
+	p->order_map = (uint8_t *) *bm_base + bm_pages;
+	p->links = (struct list_elem *) (p->order_map + om_pages);
 	p->base = (void *) start;
 
 	// Mark all to unusable.
 	bitmap_set_all(p->used_map, true);
+	memset (p->order_map, 0, pgcnt);
+	for (order = 0; order <= MAX_ORDER; order++)
+		list_init (&p->free_lists[order]);
+	p->zero_top = NULL;
+	p->zero_cnt = 0;
+
+	*bm_base += bm_pages + om_pages + ln_pages;
+}
+
+/* Returns the free list element of the block at PAGE_IDX in
+   POOL. */
+static struct list_elem *
+block_elem (const struct pool *pool, size_t page_idx) {
+	return &pool->links[page_idx];
+}
+
+/* Adds the free block of 2**ORDER pages at PAGE_IDX to POOL,
+   merging it with its buddy for as long as the buddy is free. */
+static void
+free_block (struct pool *pool, size_t page_idx, int order) {
+	size_t page_cnt = bitmap_size (pool->used_map);
+
+	while (order < MAX_ORDER) {
+		size_t buddy_idx = page_idx ^ ((size_t) 1 << order);
+
+		if (buddy_idx >= page_cnt
+				|| pool->order_map[buddy_idx] != (ORDER_FREE | order))
+			break;
+
+		/* Take the buddy off its free list and merge. */
+		list_remove (block_elem (pool, buddy_idx));
+		pool->order_map[buddy_idx] = 0;
+		if (buddy_idx < page_idx)
+			page_idx = buddy_idx;
+		order++;
+	}
+
+	pool->order_map[page_idx] = ORDER_FREE | order;
+	list_push_front (&pool->free_lists[order], block_elem (pool, page_idx));
+}
+
+/* Frees the PAGE_CNT pages starting at PAGE_IDX in POOL, which
+   need not form a single block.  The range is split into the
+   largest aligned blocks it contains. */
+static void
+pool_free (struct pool *pool, size_t page_idx, size_t page_cnt) {
+	ASSERT (bitmap_all (pool->used_map, page_idx, page_cnt));
+	bitmap_set_multiple (pool->used_map, page_idx, page_cnt, false);
+
+	while (page_cnt > 0) {
+		int order = 0;
+
+		while (order < MAX_ORDER
+				&& (page_idx & ((size_t) 1 << order)) == 0
+				&& ((size_t) 2 << order) <= page_cnt)
+			order++;
+
+		free_block (pool, page_idx, order);
+		page_idx += (size_t) 1 << order;
+		page_cnt -= (size_t) 1 << order;
+	}
+}
+
+/* Allocates PAGE_CNT contiguous pages from POOL and returns the
+   index of the first one, or BITMAP_ERROR if there is no free
+   block large enough. */
+static size_t
+pool_alloc (struct pool *pool, size_t page_cnt) {
+	size_t page_idx, block_cnt;
+	int order, want;
+
+	/* Find the smallest order that fits, then the smallest
+	   nonempty free list at or above it. */
+	for (want = 0; ((size_t) 1 << want) < page_cnt; want++)
+		if (want == MAX_ORDER)
+			return BITMAP_ERROR;
+	for (order = want; order <= MAX_ORDER; order++)
+		if (!list_empty (&pool->free_lists[order]))
+			break;
+	if (order > MAX_ORDER)
+		return BITMAP_ERROR;
+
+	page_idx = list_pop_front (&pool->free_lists[order]) - pool->links;
+	pool->order_map[page_idx] = 0;
+
+	/* Split off upper halves until the block is the right size. */
+	while (order > want) {
+		order--;
+		free_block (pool, page_idx + ((size_t) 1 << order), order);
+	}
 
-	*bm_base += bm_pages;
+	/* Give back the pages past PAGE_CNT. */
+	block_cnt = (size_t) 1 << want;
+	bitmap_set_multiple (pool->used_map, page_idx, block_cnt, true);
+	if (block_cnt > page_cnt)
+		pool_free (pool, page_idx + page_cnt, block_cnt - page_cnt);
+	return page_idx;
 }
 
 /* Returns true if PAGE was allocated from POOL,
@@ -356,3 +534,81 @@ page_from_pool (const struct pool *pool, void *page) {
 	size_t end_page = start_page + bitmap_size (pool->used_map);
 	return page_no >= start_page && page_no < end_page;
 }
+
+/* Pops a page from POOL's pre-zeroed stack and returns it, or
+   returns a null pointer if the stack is empty.  Counts the
+   request as a hit or a miss. */
+static void *
+zero_get (struct pool *pool) {
+	enum intr_level old_level;
+	void *page;
+
+	old_level = intr_disable ();
+	page = pool->zero_top;
+	if (page != NULL) {
+		pool->zero_top = *(void **) page;
+		pool->zero_cnt--;
+		pool->zero_hits++;
+	} else
+		pool->zero_misses++;
+	intr_set_level (old_level);
+
+	if (page != NULL)
+		*(void **) page = NULL;
+	return page;
+}
+
+/* Gives every page on POOL's pre-zeroed stack back to the buddy
+   allocator.  Returns true if there were any.  Interrupts must be
+   off. */
+static bool
+zero_drain (struct pool *pool) {
+	void *page;
+
+	ASSERT (intr_get_level () == INTR_OFF);
+
+	page = pool->zero_top;
+	pool->zero_top = NULL;
+	pool->zero_cnt = 0;
+
+	if (page == NULL)
+		return false;
+	while (page != NULL) {
+		void *next = *(void **) page;
+		pool_free (pool, pg_no (page) - pg_no (pool->base), 1);
+		page = next;
+	}
+	return true;
+}
+
+/* If POOL's pre-zeroed stack is below ZERO_TARGET, takes a free
+   page from POOL, zeroes it and pushes it on the stack.  Returns
+   true if a page was zeroed.
+
+   This runs in the idle thread, which must never block; taking
+   the page with interrupts off never does. */
+static bool
+zero_one (struct pool *pool) {
+	enum intr_level old_level;
+	size_t page_idx;
+	void *page;
+
+	if (pool->zero_cnt >= ZERO_TARGET)
+		return false;
+
+	old_level = intr_disable ();
+	page_idx = pool_alloc (pool, 1);
+	intr_set_level (old_level);
+	if (page_idx == BITMAP_ERROR)
+		return false;
+
+	page = pool->base + PGSIZE * page_idx;
+	memset (page, 0, PGSIZE);
+
+	old_level = intr_disable ();
+	*(void **) page = pool->zero_top;
+	pool->zero_top = page;
+	pool->zero_cnt++;
+	intr_set_level (old_level);
+	return true;
+}
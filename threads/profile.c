@@ -0,0 +1,153 @@
+#include "threads/profile.h"
+
+#include <debug.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "threads/interrupt.h"
+#include "threads/palloc.h"
+#include "threads/vaddr.h"
+
+/* 히스토그램 슬롯 수. 2의 거듭제곱이어야 합니다. */
+/* Slots in the histogram.  Must be a power of 2. */
+#define PROFILE_BITS 12
+#define PROFILE_SLOTS (1 << PROFILE_BITS)
+#define PROFILE_PAGES (PROFILE_SLOTS * sizeof(struct profile_slot) / PGSIZE)
+
+/* 선형 탐사로 확인하는 최대 슬롯 수. */
+/* Most slots probed before a sample is dropped. */
+#define PROFILE_PROBES 16
+
+/* 보고서에 출력할 최대 주소 수. */
+/* Most addresses printed in the report. */
+#define PROFILE_REPORT_MAX 32
+
+/* 히스토그램 슬롯 하나. RIP이 0이면 비어 있습니다. */
+/* One histogram slot, empty if RIP is 0. */
+struct profile_slot {
+    uint64_t rip;   /* 표본이 가리킨 명령어 주소. */ /* Sampled instruction address. */
+    uint64_t count; /* 표본 수. */                   /* Number of samples. */
+};
+
+/* true이면 타이머 인터럽트가 표본을 기록합니다.
+   커널 명령 줄 옵션 "-profile"에 의해 제어됩니다. */
+/* If true, timer interrupts record samples.
+   Controlled by kernel command-line option "-profile". */
+bool profile_enabled;
+
+/* 히스토그램. */
+/* The histogram. */
+static struct profile_slot *profile_slots;
+
+/* 통계. */
+/* Statistics. */
+static uint64_t kernel_samples; /* 커널 모드 표본 수. */         /* # of samples in kernel mode. */
+static uint64_t user_samples;   /* 사용자 모드 표본 수. */       /* # of samples in user mode. */
+static uint64_t dropped_samples; /* 슬롯을 찾지 못한 표본 수. */ /* # of samples with no free slot. */
+
+/* "-profile"이 주어졌으면 히스토그램을 할당합니다. palloc_init() 이후에
+   호출해야 합니다. */
+/* Allocates the histogram if "-profile" was given.  Must be
+   called after palloc_init(). */
+void profile_init(void) {
+    if (!profile_enabled)
+        return;
+
+    profile_slots = palloc_get_multiple(PAL_ZERO, PROFILE_PAGES);
+    if (profile_slots == NULL) {
+        printf("profile: no memory for histogram, profiling disabled\n");
+        profile_enabled = false;
+    }
+}
+
+/* RIP 주소의 표본 하나를 기록합니다. USER는 사용자 모드에서 중단되었는지를
+   나타냅니다. 타이머 인터럽트 핸들러에서 호출되므로 락을 잡아서는 안 됩니다.
+   인터럽트가 꺼진 채 실행되므로 히스토그램을 그대로 고칩니다. */
+/* Records one sample at address RIP, taken in user mode if USER
+   is true.  Called from the timer interrupt handler, so it must
+   not take a lock; it runs with interrupts off and updates the
+   histogram directly. */
+void profile_sample(uintptr_t rip, bool user) {
+    size_t idx;
+    int probe;
+
+    ASSERT(intr_context());
+
+    if (profile_slots == NULL)
+        return;
+
+    if (user)
+        user_samples++;
+    else
+        kernel_samples++;
+
+    /* 피보나치 해싱 후 선형 탐사. */
+    /* Fibonacci hashing, then linear probing. */
+    idx = (rip * 0x9e3779b97f4a7c15ULL) >> (64 - PROFILE_BITS);
+    for (probe = 0; probe < PROFILE_PROBES; probe++) {
+        struct profile_slot *s = &profile_slots[(idx + probe) & (PROFILE_SLOTS - 1)];
+
+        if (s->rip == 0)
+            s->rip = rip;
+        if (s->rip == rip) {
+            s->count++;
+            return;
+        }
+    }
+    dropped_samples++;
+}
+
+/* 표본 수 내림차순 비교 함수. */
+/* Orders slots by descending sample count. */
+static int slot_compare(const void *a_, const void *b_) {
+    const struct profile_slot *a = a_;
+    const struct profile_slot *b = b_;
+
+    return a->count < b->count ? 1 : a->count > b->count ? -1 : 0;
+}
+
+/* 프로파일 보고서를 출력합니다. 가장 많이 표본이 잡힌 주소부터 표본 수와
+   비율을 출력하고, 마지막 줄에 utils/backtrace에 넘길 주소 목록을 출력합니다.
+   표본 수집을 끄고 히스토그램을 떼어 낸 뒤 정렬하므로, 이후의 표본은
+   버립니다. */
+/* Prints the profile: the most-sampled addresses with their
+   sample counts and shares, then a line listing the same
+   addresses to pass to utils/backtrace.  Sampling is turned off
+   and the histogram detached before it is sorted in place, so
+   sampling stops for good. */
+void profile_print_stats(void) {
+    struct profile_slot *slots;
+    enum intr_level old_level;
+    uint64_t total;
+    int i;
+
+    /* 타이머 인터럽트가 정렬 중인 히스토그램을 건드리지 못하게 합니다. */
+    /* Keep the timer interrupt off the histogram being sorted. */
+    old_level = intr_disable();
+    profile_enabled = false;
+    slots = profile_slots;
+    profile_slots = NULL;
+    intr_set_level(old_level);
+
+    if (slots == NULL)
+        return;
+    total = kernel_samples + user_samples;
+
+    qsort(slots, PROFILE_SLOTS, sizeof *slots, slot_compare);
+    printf("Profile: %" PRIu64 " samples (%" PRIu64 " kernel, %" PRIu64 " user), %" PRIu64
+           " dropped\n",
+           total, kernel_samples, user_samples, dropped_samples);
+    for (i = 0; i < PROFILE_REPORT_MAX && slots[i].count > 0; i++) {
+        uint64_t permille = slots[i].count * 1000 / total;
+
+        printf("Profile: %8" PRIu64 " %3" PRIu64 ".%" PRIu64 "%% %#018" PRIx64 "%s\n",
+               slots[i].count, permille / 10, permille % 10, slots[i].rip,
+               is_user_vaddr((void *)slots[i].rip) ? " (user)" : "");
+    }
+
+    printf("Profile addresses:");
+    for (i = 0; i < PROFILE_REPORT_MAX && slots[i].count > 0; i++)
+        printf(" %#" PRIx64, slots[i].rip);
+    printf("\nRun `backtrace' on the profile addresses to symbolize them.\n");
+}
@@ -0,0 +1,202 @@
+#include "threads/slab.h"
+#include <debug.h>
+#include <round.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "threads/palloc.h"
+#include "threads/vaddr.h"
+
+/* A slab allocator, after Bonwick, "The Slab Allocator: An
+   Object-Caching Kernel Memory Allocator".
+
+   Each cache hands out objects of a single size, so unlike
+   malloc() there is no rounding up to a power of 2.  A cache
+   carves one-page "slabs" into objects, and a slab's header sits
+   at the start of its page, so the slab that owns an object is
+   found by rounding the object's address down.
+
+   Objects are "constructed" once, when their slab is created,
+   and a freed object is expected to be returned in its
+   constructed state.  To make that possible the free list is not
+   threaded through the objects themselves but through a link
+   word that follows each object.
+
+   A slab that becomes wholly free is kept as the cache's reserve
+   if the cache has none, so that a cache oscillating around a
+   slab boundary does not thrash the page allocator; otherwise it
+   goes back to the page allocator. */
+
+/* Magic number for detecting slab corruption. */
+#define SLAB_MAGIC 0x51ab51ab
+
+/* Slab header, at the start of the slab's page. */
+struct slab {
+	unsigned magic;             /* Always set to SLAB_MAGIC. */
+	struct slab_cache *cache;   /* Owning cache. */
+	struct list_elem elem;      /* Element in cache's PARTIAL or FULL. */
+	void *free;                 /* First free object, or null. */
+	size_t in_use;              /* Objects allocated from this slab. */
+};
+
+/* All caches, for slab_print_stats(). */
+static struct list caches;
+
+static struct slab *slab_create (struct slab_cache *);
+static void **free_link (struct slab_cache *, void *obj);
+
+/* Initializes the slab allocator. */
+void
+slab_init (void) {
+	list_init (&caches);
+}
+
+/* Initializes CACHE to hand out SIZE-byte objects, each
+   constructed with CTOR (if nonnull) when its slab is created.
+   NAME identifies the cache in statistics. */
+void
+slab_cache_init (struct slab_cache *cache, const char *name, size_t size,
+		slab_ctor_func *ctor) {
+	ASSERT (cache != NULL);
+	ASSERT (size > 0);
+
+	cache->name = name;
+	cache->obj_size = size;
+	cache->stride = ROUND_UP (size, sizeof (void *)) + sizeof (void *);
+	cache->objs_per_slab = (PGSIZE - sizeof (struct slab)) / cache->stride;
+	ASSERT (cache->objs_per_slab >= 8);
+	cache->ctor = ctor;
+	lock_init_named (&cache->lock, name);
+	list_init (&cache->partial);
+	list_init (&cache->full);
+	cache->empty = NULL;
+	cache->slab_cnt = 0;
+	cache->in_use = 0;
+	list_push_back (&caches, &cache->elem);
+}
+
+/* Obtains and returns an object from CACHE, in constructed
+   state.  Returns a null pointer if memory is not available. */
+void *
+slab_alloc (struct slab_cache *cache) {
+	struct slab *slab;
+	void *obj;
+
+	ASSERT (cache != NULL);
+
+	lock_acquire (&cache->lock);
+	if (!list_empty (&cache->partial))
+		slab = list_entry (list_front (&cache->partial), struct slab, elem);
+	else {
+		if (cache->empty != NULL) {
+			slab = cache->empty;
+			cache->empty = NULL;
+		} else {
+			slab = slab_create (cache);
+			if (slab == NULL) {
+				lock_release (&cache->lock);
+				return NULL;
+			}
+		}
+		list_push_front (&cache->partial, &slab->elem);
+	}
+
+	obj = slab->free;
+	slab->free = *free_link (cache, obj);
+	slab->in_use++;
+	cache->in_use++;
+	if (slab->free == NULL) {
+		list_remove (&slab->elem);
+		list_push_front (&cache->full, &slab->elem);
+	}
+	lock_release (&cache->lock);
+	return obj;
+}
+
+/* Returns OBJ, which must have been allocated from CACHE and must
+   be back in its constructed state, to CACHE.  A null OBJ is
+   ignored. */
+void
+slab_free (struct slab_cache *cache, void *obj) {
+	struct slab *slab;
+
+	if (obj == NULL)
+		return;
+
+	slab = pg_round_down (obj);
+	ASSERT (slab->magic == SLAB_MAGIC);
+	ASSERT (slab->cache == cache);
+
+	lock_acquire (&cache->lock);
+	if (slab->free == NULL) {
+		list_remove (&slab->elem);
+		list_push_front (&cache->partial, &slab->elem);
+	}
+	*free_link (cache, obj) = slab->free;
+	slab->free = obj;
+	slab->in_use--;
+	cache->in_use--;
+
+	if (slab->in_use == 0) {
+		list_remove (&slab->elem);
+		if (cache->empty == NULL)
+			cache->empty = slab;
+		else {
+			cache->slab_cnt--;
+			slab->magic = 0;
+			palloc_free_page (slab);
+		}
+	}
+	lock_release (&cache->lock);
+}
+
+/* Prints the objects in use and slabs held by each cache. */
+void
+slab_print_stats (void) {
+	struct list_elem *e;
+
+	for (e = list_begin (&caches); e != list_end (&caches); e = list_next (e)) {
+		struct slab_cache *cache = list_entry (e, struct slab_cache, elem);
+
+		printf ("Slab: %s: %zu objects of %zu bytes in use, %zu slabs\n",
+				cache->name, cache->in_use, cache->obj_size, cache->slab_cnt);
+	}
+}
+
+/* Allocates a new slab for CACHE, constructs its objects and
+   threads them onto its free list.  Returns the slab, or a null
+   pointer if no page is available.  CACHE's lock must be held. */
+static struct slab *
+slab_create (struct slab_cache *cache) {
+	struct slab *slab = palloc_get_page (0);
+	uint8_t *objs;
+	size_t i;
+
+	if (slab == NULL)
+		return NULL;
+
+	slab->magic = SLAB_MAGIC;
+	slab->cache = cache;
+	slab->in_use = 0;
+	slab->free = NULL;
+
+	/* Thread back to front, so that objects go out in address
+	   order. */
+	objs = (uint8_t *) (slab + 1);
+	for (i = cache->objs_per_slab; i-- > 0; ) {
+		void *obj = objs + i * cache->stride;
+
+		if (cache->ctor != NULL)
+			cache->ctor (obj);
+		*free_link (cache, obj) = slab->free;
+		slab->free = obj;
+	}
+	cache->slab_cnt++;
+	return slab;
+}
+
+/* Returns the free-list link word that follows OBJ in CACHE. */
+static void **
+free_link (struct slab_cache *cache, void *obj) {
+	return (void **) ((uint8_t *) obj + cache->stride - sizeof (void *));
+}
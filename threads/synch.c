@@ -45,8 +45,12 @@
    */
 
 #include "threads/synch.h"
+#include <inttypes.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include "intrinsic.h"
+#include "devices/timer.h"
 #include "threads/interrupt.h"
 #include "threads/thread.h"
 
@@ -70,13 +74,40 @@
 
    - up or "V": increment the value (and wake up one waiting
    thread, if any). */
-struct lock filesys_lock;
+static bool waiter_less (const struct pheap_elem *, const struct pheap_elem *,
+		void *aux);
+static void waiter_push (struct pheap *, struct thread *);
+static struct thread *waiter_pop (struct pheap *);
+static void cond_wake (struct thread *);
+static void lock_acquire_slow (struct lock *);
+static void lock_release_slow (struct lock *);
+static struct lock_class *lock_class_lookup (const char *name);
+static uint64_t lockstat_acquired (struct lock_class *, uint64_t start);
+
+/* LOCK의 owner가 OLD이면 NEW로 바꾸고 true를 반환합니다. */
+/* Atomically changes LOCK's owner word from OLD to NEW and
+   returns true, or returns false if it was not OLD. */
+static inline bool
+lock_cas (struct lock *lock, uintptr_t old, uintptr_t new) {
+	return __atomic_compare_exchange_n (&lock->owner, &old, new, false,
+			__ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+/* 대기 큐에 들어간 순서. 같은 우선순위끼리는 먼저 기다린 스레드가 먼저 깨어납니다. */
+/* Order in which threads joined wait queues, so that threads of
+   equal priority wake in FIFO order. */
+static uint64_t wait_seq;
 
-void sema_init(struct semaphore *sema, unsigned value) {
-    ASSERT(sema != NULL);
+/* NAME은 경쟁 통계의 클래스 이름이며, 보통 sema_init()이 넘겨주는 호출 위치입니다. */
+/* NAME is SEMA's lockstat class, normally the call site passed
+   in by the sema_init() macro.  It must outlive SEMA. */
+void
+sema_init_named (struct semaphore *sema, unsigned value, const char *name) {
+	ASSERT (sema != NULL);
 
 	sema->value = value;
-	list_init (&sema->waiters);
+	pheap_init (&sema->waiters, waiter_less, NULL);
+	sema->class = lock_class_lookup (name);
 }
 
 /* 세마포어에 대한 Down 또는 "P" 연산입니다. SEMA의 값이 양수가 될 때까지 기다린 다음 원자적으로 값을 감소시킵니다.
@@ -103,17 +134,21 @@ void sema_init(struct semaphore *sema, unsigned value) {
 void
 sema_down (struct semaphore *sema) {
 	enum intr_level old_level;
+	uint64_t start = 0;
 
 	ASSERT (sema != NULL);
 	ASSERT (!intr_context ());
 
 	old_level = intr_disable ();
+	if (lockstat_enabled && sema->value == 0)
+		start = rdtsc ();
 	while (sema->value == 0) {
-		// list_push_back (&sema->waiters, &thread_current ()->elem);
-		list_insert_desc_ordered (&sema->waiters, &thread_current ()->elem, less_priority, NULL);
+		waiter_push (&sema->waiters, thread_current ());
 		thread_block ();
 	}
 	sema->value--;
+	if (lockstat_enabled)
+		lockstat_acquired (sema->class, start);
 	intr_set_level (old_level);
 }
 
@@ -138,6 +173,8 @@ sema_try_down (struct semaphore *sema) {
 	{
 		sema->value--;
 		success = true;
+		if (lockstat_enabled)
+			lockstat_acquired (sema->class, 0);
 	}
 	else
 		success = false;
@@ -161,11 +198,8 @@ sema_up (struct semaphore *sema) {
 	ASSERT (sema != NULL);
 
 	old_level = intr_disable ();
-	if (!list_empty (&sema->waiters)){
-		list_sort (&sema->waiters, more_priority, 0);
-		thread_unblock (list_entry (list_pop_front (&sema->waiters),
-					struct thread, elem));
-	}
+	if (!pheap_empty (&sema->waiters))
+		thread_unblock (waiter_pop (&sema->waiters));
 	sema->value++;
 	test_max_priority();
 	intr_set_level (old_level);
@@ -234,12 +268,19 @@ sema_test_helper (void *sema_) {
    acquire and release it.  When these restrictions prove
    onerous, it's a good sign that a semaphore should be used,
    instead of a lock. */
+/* NAME은 경쟁 통계의 클래스 이름이며, 보통 lock_init()이 넘겨주는 호출 위치입니다. */
+/* NAME is LOCK's lockstat class, normally the call site passed
+   in by the lock_init() macro.  It must outlive LOCK. */
 void
-lock_init (struct lock *lock) {
+lock_init_named (struct lock *lock, const char *name) {
 	ASSERT (lock != NULL);
 
 	lock->holder = NULL;
-	sema_init (&lock->semaphore, 1);
+	lock->owner = 0;
+	pheap_init (&lock->waiters, waiter_less, NULL);
+	lock->donated_tickets = 0;
+	lock->class = lock_class_lookup (name);
+	lock->acquired_tsc = 0;
 }
 
 /* LOCK을 획득하며, 필요한 경우 사용 가능할 때까지 대기합니다. 현재 스레드가 이미 잠금을 보유하고 있으면 안 됩니다.
@@ -253,23 +294,73 @@ lock_init (struct lock *lock) {
    This function may sleep, so it must not be called within an
    interrupt handler.  This function may be called with
    interrupts disabled, but interrupts will be turned back on if
-   we need to sleep. */
+   we need to sleep.
+
+   경쟁이 없으면 원자적 비교-교환 한 번으로 끝나며, 인터럽트를 끄지 않습니다. */
+/* An uncontended acquire is a single atomic compare-and-swap and
+   does not touch the interrupt level. */
 void
 lock_acquire (struct lock *lock) {
+	struct thread *curr = thread_current ();
+
 	ASSERT (lock != NULL);
 	ASSERT (!intr_context ());
 	ASSERT (!lock_held_by_current_thread (lock));
-	struct thread *curr = thread_current();
 
-	if (lock->holder) {
-		curr->wait_on_lock = lock;
-		list_insert_ordered(&lock->holder->donations, &curr->donation_elem, thread_compare_donate_priority, NULL);
-		donate_priority();
+	if (lock_cas (lock, 0, (uintptr_t) curr)) {
+		lock->holder = curr;
+		if (lockstat_enabled)
+			lock->acquired_tsc = lockstat_acquired (lock->class, 0);
+	} else {
+		uint64_t start = lockstat_enabled ? rdtsc () : 0;
+
+		lock_acquire_slow (lock);
+		if (lockstat_enabled)
+			lock->acquired_tsc = lockstat_acquired (lock->class, start);
 	}
-	
-  	sema_down (&lock->semaphore);
-  	curr->wait_on_lock = NULL;
+}
+
+/* 경쟁이 있을 때의 lock_acquire()입니다. LOCK_WAITERS를 세워 해제하는 스레드가
+   느린 경로를 타게 한 뒤, 우선순위를 기부하고 잠듭니다. 깨어났을 때는 해제한
+   스레드가 이미 LOCK을 넘겨준 상태입니다. */
+/* Contended half of lock_acquire().  Sets LOCK_WAITERS so that
+   the owner's release takes the slow path, donates priority and
+   sleeps.  The releasing thread hands LOCK over directly, so by
+   the time we wake up we own it. */
+static void
+lock_acquire_slow (struct lock *lock) {
+	struct thread *curr = thread_current ();
+	enum intr_level old_level;
+
+	old_level = intr_disable ();
+	for (;;) {
+		uintptr_t owner = lock->owner;
+
+		if (owner == 0) {
+			if (lock_cas (lock, 0, (uintptr_t) curr))
+				break;
+		} else {
+			struct thread *holder = (struct thread *) (owner & ~LOCK_WAITERS);
+
+			if (!(owner & LOCK_WAITERS)) {
+				if (!lock_cas (lock, owner, owner | LOCK_WAITERS))
+					continue;
+				/* 첫 대기자이므로 LOCK을 보유자의 held_locks에 넣습니다. */
+				/* First waiter: LOCK now donates to its holder. */
+				list_push_back (&holder->held_locks, &lock->held_elem);
+			}
+			curr->wait_on_lock = lock;
+			waiter_push (&lock->waiters, curr);
+			if (!thread_mlfqs && !thread_cfs)
+				donate_priority ();
+			thread_block ();
+			ASSERT (lock_owner (lock) == curr);
+			break;
+		}
+	}
+	curr->wait_on_lock = NULL;
 	lock->holder = curr;
+	intr_set_level (old_level);
 }
 
 /* LOCK을 획득하려고 시도하고, 성공하면 true를 실패하면 false를 반환합니다.
@@ -289,9 +380,12 @@ lock_try_acquire (struct lock *lock) {
 	ASSERT (lock != NULL);
 	ASSERT (!lock_held_by_current_thread (lock));
 
-	success = sema_try_down (&lock->semaphore);
-	if (success)
+	success = lock_cas (lock, 0, (uintptr_t) thread_current ());
+	if (success) {
 		lock->holder = thread_current ();
+		if (lockstat_enabled)
+			lock->acquired_tsc = lockstat_acquired (lock->class, 0);
+	}
 	return success;
 }
 
@@ -304,17 +398,56 @@ lock_try_acquire (struct lock *lock) {
 
    An interrupt handler cannot acquire a lock, so it does not
    make sense to try to release a lock within an interrupt
-   handler. */
+   handler.
+
+   기다리는 스레드가 없으면 원자적 비교-교환 한 번으로 끝납니다. */
+/* With no waiters, releasing is a single atomic compare-and-swap.
+   Only waiters can have donated to us through LOCK, so there is
+   no donation to undo in that case either. */
 void
 lock_release (struct lock *lock) {
+	struct thread *curr = thread_current ();
+
 	ASSERT (lock != NULL);
 	ASSERT (lock_held_by_current_thread (lock));
 
-	remove_with_lock(lock);
-	refresh_priority();
-
+	if (lock->acquired_tsc != 0) {
+		if (lock->class != NULL)
+			__atomic_fetch_add (&lock->class->hold_cycles,
+					rdtsc () - lock->acquired_tsc, __ATOMIC_RELAXED);
+		lock->acquired_tsc = 0;
+	}
 	lock->holder = NULL;
-	sema_up (&lock->semaphore);
+	if (!lock_cas (lock, (uintptr_t) curr, 0))
+		lock_release_slow (lock);
+}
+
+/* 기다리는 스레드가 있을 때의 lock_release()입니다. 가장 높은 우선순위의 대기자에게
+   LOCK을 직접 넘겨주며, LOCK을 통한 기부도 그 스레드에게 옮겨 갑니다. */
+/* Contended half of lock_release().  Hands LOCK directly to its
+   highest-priority waiter, so that a thread running in the
+   meantime cannot take it out from under the waiter, and moves
+   the donations of the remaining waiters over to it. */
+static void
+lock_release_slow (struct lock *lock) {
+	struct thread *next;
+	enum intr_level old_level;
+
+	old_level = intr_disable ();
+	next = waiter_pop (&lock->waiters);
+	next->wait_on_lock = NULL;
+	list_remove (&lock->held_elem);
+	if (!pheap_empty (&lock->waiters))
+		list_push_back (&next->held_locks, &lock->held_elem);
+	if (!thread_mlfqs && !thread_cfs)
+		donate_handoff (lock, next);
+
+	lock->holder = next;
+	__atomic_store_n (&lock->owner, (uintptr_t) next
+			| (pheap_empty (&lock->waiters) ? 0 : LOCK_WAITERS), __ATOMIC_RELEASE);
+	thread_unblock (next);
+	test_max_priority ();
+	intr_set_level (old_level);
 }
 
 /* 현재 스레드가 LOCK을 보유하고 있는지 여부를 반환합니다. 
@@ -326,16 +459,20 @@ bool
 lock_held_by_current_thread (const struct lock *lock) {
 	ASSERT (lock != NULL);
 
-	return lock->holder == thread_current ();
+	return lock_owner (lock) == thread_current ();
 }
-
-/* 리스트에 있는 세마포어 하나를 나타내는 구조체입니다. */
-/* One semaphore in a list. */
-struct semaphore_elem {
-	struct list_elem elem;              /* 리스트 요소입니다. *//* List element. */
-	struct semaphore semaphore;         /* 이 세마포어입니다. *//* This semaphore. */
-};
 
+/* LOCK을 보유한 스레드를 반환하며, 없으면 NULL을 반환합니다. */
+/* Returns the thread that owns LOCK, or a null pointer if it is
+   free.  Unlike `holder', this is exact even in the instant
+   after a fast-path acquire. */
+struct thread *
+lock_owner (const struct lock *lock) {
+	ASSERT (lock != NULL);
+
+	return (struct thread *) (lock->owner & ~LOCK_WAITERS);
+}
+
 /* 조건 변수 COND를 초기화합니다. 조건 변수는 한 조각의 코드가 조건을 신호하고, 협력하는
    코드가 그 신호를 받아들이고 그에 따라 작업을 수행할 수 있도록 합니다. */
 /* Initializes condition variable COND.  A condition variable
@@ -345,7 +482,7 @@ void
 cond_init (struct condition *cond) {
 	ASSERT (cond != NULL);
 
-	list_init (&cond->waiters);
+	pheap_init (&cond->waiters, waiter_less, NULL);
 }
 
 /* LOCK을 원자적으로 해제하고, 다른 조각의 코드에 의해 COND가 신호되기를 기다립니다. 
@@ -382,18 +519,28 @@ cond_init (struct condition *cond) {
    we need to sleep. */
 void
 cond_wait (struct condition *cond, struct lock *lock) {
-	struct semaphore_elem waiter;
+	struct thread *curr = thread_current ();
+	enum intr_level old_level;
 
 	ASSERT (cond != NULL);
 	ASSERT (lock != NULL);
 	ASSERT (!intr_context ());
 	ASSERT (lock_held_by_current_thread (lock));
 
-	sema_init (&waiter.semaphore, 0);
-	// list_push_back (&cond->waiters, &waiter.elem);
-	list_insert_desc_ordered(&cond->waiters, &waiter.elem, sema_compare_priority, NULL);
+	old_level = intr_disable ();
+	curr->wait_signaled = false;
+	waiter_push (&cond->waiters, curr);
 	lock_release (lock);
-	sema_down (&waiter.semaphore);
+
+	/* lock_release()가 더 높은 우선순위의 스레드에게 양보했다면, 잠들기 전에 이미
+	   신호를 받았을 수도 있습니다. */
+	/* lock_release() may have yielded to a higher-priority
+	   thread, so we may already have been signaled before getting
+	   to sleep. */
+	while (!curr->wait_signaled)
+		thread_block ();
+	intr_set_level (old_level);
+
 	lock_acquire (lock);
 }
 
@@ -410,16 +557,17 @@ cond_wait (struct condition *cond, struct lock *lock) {
    interrupt handler. */
 void
 cond_signal (struct condition *cond, struct lock *lock UNUSED) {
+	enum intr_level old_level;
+
 	ASSERT (cond != NULL);
 	ASSERT (lock != NULL);
 	ASSERT (!intr_context ());
 	ASSERT (lock_held_by_current_thread (lock));
 
-	if (!list_empty (&cond->waiters)) {
-		list_sort(&cond->waiters, sema_compare_priority, NULL);
-		sema_up (&list_entry (list_pop_front (&cond->waiters),
-					struct semaphore_elem, elem)->semaphore);
-	}
+	old_level = intr_disable ();
+	if (!pheap_empty (&cond->waiters))
+		cond_wake (waiter_pop (&cond->waiters));
+	intr_set_level (old_level);
 }
 
 /* COND (LOCK에 의해 보호됨)에 대기 중인 모든 스레드를 깨웁니다.
@@ -434,21 +582,291 @@ cond_signal (struct condition *cond, struct lock *lock UNUSED) {
    interrupt handler. */
 void
 cond_broadcast (struct condition *cond, struct lock *lock) {
+	enum intr_level old_level;
+
 	ASSERT (cond != NULL);
 	ASSERT (lock != NULL);
+	ASSERT (!intr_context ());
+	ASSERT (lock_held_by_current_thread (lock));
 
-	while (!list_empty (&cond->waiters))
-		cond_signal (cond, lock);
+	/* cond_signal()과 같은 우선순위/FIFO 순서로 깨우도록 하나씩 꺼냅니다.
+	   대기자 n개에 O(n log n)이 들지만 순서를 지킵니다. */
+	/* Pop the waiters one at a time, so that they wake in the same
+	   priority and FIFO order as with cond_signal().  That takes
+	   O(n log n) for n waiters rather than O(n), in exchange for
+	   keeping the order. */
+	old_level = intr_disable ();
+	while (!pheap_empty (&cond->waiters))
+		cond_wake (waiter_pop (&cond->waiters));
+	intr_set_level (old_level);
 }
 
-/* 세마포어에서 스레드 꺼내서 우선순위 비교 */
-bool
-sema_compare_priority (struct list_elem *e1, struct list_elem *e2, void *aux) {
-	struct semaphore_elem *e1_sema = list_entry (e1, struct semaphore_elem, elem);
-	struct semaphore_elem *e2_sema = list_entry (e2, struct semaphore_elem, elem);
+/* 읽기-쓰기 락 RW를 초기화합니다. NAME은 내부 락의 경쟁 통계 클래스입니다. */
+/* Initializes reader-writer lock RW.  NAME is the lockstat class
+   of its internal lock, normally the call site passed in by the
+   rw_init() macro. */
+void
+rw_init_named (struct rwlock *rw, const char *name) {
+	ASSERT (rw != NULL);
+
+	lock_init_named (&rw->lock, name);
+	cond_init (&rw->can_read);
+	cond_init (&rw->can_write);
+	rw->readers = 0;
+	rw->waiting_writers = 0;
+	rw->writer = false;
+}
+
+/* RW를 읽기 용도로 획득합니다. 쓰기 스레드가 보유 중이거나 기다리고 있으면
+   잠듭니다. 인터럽트 핸들러 내에서 호출해서는 안 됩니다. */
+/* Acquires RW for reading, sleeping while a writer holds it or is
+   waiting for it.  Must not be called within an interrupt
+   handler. */
+void
+rw_read_acquire (struct rwlock *rw) {
+	ASSERT (rw != NULL);
+
+	lock_acquire (&rw->lock);
+	while (rw->writer || rw->waiting_writers > 0)
+		cond_wait (&rw->can_read, &rw->lock);
+	rw->readers++;
+	lock_release (&rw->lock);
+}
+
+/* 읽기 용도로 보유한 RW를 해제합니다. */
+/* Releases RW, which the current thread holds for reading. */
+void
+rw_read_release (struct rwlock *rw) {
+	ASSERT (rw != NULL);
+
+	lock_acquire (&rw->lock);
+	ASSERT (rw->readers > 0);
+	if (--rw->readers == 0 && rw->waiting_writers > 0)
+		cond_signal (&rw->can_write, &rw->lock);
+	lock_release (&rw->lock);
+}
+
+/* RW를 쓰기 용도로 획득합니다. 다른 스레드가 어떤 용도로든 보유 중이면 잠듭니다.
+   인터럽트 핸들러 내에서 호출해서는 안 됩니다. */
+/* Acquires RW for writing, sleeping while any other thread holds
+   it.  Must not be called within an interrupt handler. */
+void
+rw_write_acquire (struct rwlock *rw) {
+	ASSERT (rw != NULL);
+
+	lock_acquire (&rw->lock);
+	rw->waiting_writers++;
+	while (rw->writer || rw->readers > 0)
+		cond_wait (&rw->can_write, &rw->lock);
+	rw->waiting_writers--;
+	rw->writer = true;
+	lock_release (&rw->lock);
+}
+
+/* 쓰기 용도로 보유한 RW를 해제합니다. 기다리는 쓰기 스레드가 있으면 하나를,
+   없으면 기다리는 모든 읽기 스레드를 깨웁니다. */
+/* Releases RW, which the current thread holds for writing.  Wakes
+   one waiting writer if there is one, otherwise every waiting
+   reader. */
+void
+rw_write_release (struct rwlock *rw) {
+	ASSERT (rw != NULL);
+
+	lock_acquire (&rw->lock);
+	ASSERT (rw->writer);
+	rw->writer = false;
+	if (rw->waiting_writers > 0)
+		cond_signal (&rw->can_write, &rw->lock);
+	else
+		cond_broadcast (&rw->can_read, &rw->lock);
+	lock_release (&rw->lock);
+}
+
+/* 대기 큐 순서: 높은 우선순위가 먼저, 같으면 먼저 기다린 스레드가 먼저입니다. */
+/* Orders wait queues: higher priority first, then first come,
+   first served. */
+static bool
+waiter_less (const struct pheap_elem *a_, const struct pheap_elem *b_,
+		void *aux UNUSED) {
+	const struct thread *a = pheap_entry (a_, struct thread, wait_elem);
+	const struct thread *b = pheap_entry (b_, struct thread, wait_elem);
+
+	if (a->priority != b->priority)
+		return a->priority > b->priority;
+	return a->wait_seq < b->wait_seq;
+}
+
+/* T를 대기 큐 WAITERS에 넣습니다. 인터럽트가 꺼져 있어야 합니다. */
+/* Adds T to wait queue WAITERS.  Interrupts must be off. */
+static void
+waiter_push (struct pheap *waiters, struct thread *t) {
+	ASSERT (intr_get_level () == INTR_OFF);
+	ASSERT (t->wait_queue == NULL);
+
+	t->wait_seq = wait_seq++;
+	t->wait_queue = waiters;
+	pheap_insert (waiters, &t->wait_elem);
+}
 
-	struct list *waiter_e1_sema = &(e1_sema->semaphore.waiters);
-	struct list *waiter_e2_sema = &(e2_sema->semaphore.waiters);
+/* 비어 있지 않은 대기 큐 WAITERS에서 가장 높은 우선순위의 스레드를 꺼냅니다.
+   인터럽트가 꺼져 있어야 합니다. */
+/* Removes and returns the highest-priority thread in non-empty
+   wait queue WAITERS.  Interrupts must be off. */
+static struct thread *
+waiter_pop (struct pheap *waiters) {
+	struct thread *t;
 
-	return list_entry(list_begin (waiter_e1_sema), struct thread, elem)->priority > list_entry (list_begin (waiter_e2_sema), struct thread, elem)->priority;
-}
\ No newline at end of file
+	ASSERT (intr_get_level () == INTR_OFF);
+
+	t = pheap_entry (pheap_pop (waiters), struct thread, wait_elem);
+	t->wait_queue = NULL;
+	return t;
+}
+
+/* 조건 변수에서 꺼낸 스레드 T에게 신호를 보냅니다. T가 아직 잠들지 않았다면
+   cond_wait()가 신호를 보고 잠들지 않습니다. */
+/* Signals T, just removed from a condition variable.  If T has
+   not gone to sleep yet, cond_wait() sees the signal and does
+   not block. */
+static void
+cond_wake (struct thread *t) {
+	t->wait_signaled = true;
+	if (t->status == THREAD_BLOCKED)
+		thread_unblock (t);
+}
+
+/* 스레드 T의 우선순위가 (기부 등으로) 바뀌었을 때 호출하여, T가 기다리는
+   대기 큐에서의 위치를 바로잡습니다. T가 기다리는 중이 아니면 아무것도 하지 않습니다. */
+/* Must be called whenever T's priority changes, for instance
+   through donation, so that T keeps its place in the wait queue
+   it is in.  Does nothing if T is not waiting. */
+void
+synch_priority_changed (struct thread *t) {
+	enum intr_level old_level;
+
+	old_level = intr_disable ();
+	if (t->wait_queue != NULL) {
+		pheap_remove (t->wait_queue, &t->wait_elem);
+		pheap_insert (t->wait_queue, &t->wait_elem);
+	}
+	intr_set_level (old_level);
+}
+
+/* 경쟁 통계 클래스 테이블의 크기. 2의 거듭제곱이어야 합니다. */
+/* Size of the lockstat class table.  Must be a power of 2. */
+#define LOCK_CLASS_BITS 8
+#define LOCK_CLASS_CNT (1 << LOCK_CLASS_BITS)
+
+/* 보고서에 출력할 최대 클래스 수. */
+/* Most classes printed by lockstat_print_stats(). */
+#define LOCKSTAT_REPORT_MAX 20
+
+/* true이면 락과 세마포어가 경쟁 통계를 모읍니다. */
+/* If true, locks and semaphores collect contention statistics. */
+bool lockstat_enabled;
+
+/* 이름 포인터로 해시되는 클래스 테이블. 한 번 들어간 클래스는 지워지지 않습니다. */
+/* Classes, hashed by name pointer.  Classes are never removed. */
+static struct lock_class lock_classes[LOCK_CLASS_CNT];
+
+/* NAME 클래스를 찾거나 새로 만들어 반환합니다. 테이블이 가득 차면 NULL을 반환하며,
+   그 객체의 통계는 모이지 않습니다. 빈 슬롯을 비교-교환으로 차지하므로 락이
+   필요 없습니다. 같은 호출 위치의 이름은 같은 문자열 상수이므로 포인터만 비교합니다. */
+/* Returns NAME's class, creating it if needed, or a null pointer
+   if the table is full, in which case the object goes
+   unaccounted.  Free slots are claimed with compare-and-swap, so
+   no lock is needed, which matters because this runs while the
+   first locks are being initialized.  Names are compared by
+   pointer: every call site passes the same string constant. */
+static struct lock_class *
+lock_class_lookup (const char *name) {
+	size_t idx = ((uintptr_t) name * 0x9e3779b97f4a7c15ULL) >> (64 - LOCK_CLASS_BITS);
+	size_t i;
+
+	for (i = 0; i < LOCK_CLASS_CNT; i++) {
+		struct lock_class *class = &lock_classes[(idx + i) & (LOCK_CLASS_CNT - 1)];
+		const char *old = NULL;
+
+		if (__atomic_compare_exchange_n (&class->name, &old, name, false,
+					__ATOMIC_RELAXED, __ATOMIC_RELAXED) || old == name)
+			return class;
+	}
+	return NULL;
+}
+
+/* CLASS에 획득 한 번을 기록합니다. START가 0이 아니면 START부터 기다린 끝에
+   얻은 것입니다. 현재 TSC 값을 반환합니다. */
+/* Records one acquisition in CLASS, which waited since TSC value
+   START unless START is 0.  Returns the current TSC value. */
+static uint64_t
+lockstat_acquired (struct lock_class *class, uint64_t start) {
+	uint64_t now = rdtsc ();
+
+	if (class == NULL)
+		return now;
+
+	__atomic_fetch_add (&class->acquisitions, 1, __ATOMIC_RELAXED);
+	if (start != 0) {
+		uint64_t wait = now - start;
+		uint64_t max = __atomic_load_n (&class->max_wait_cycles, __ATOMIC_RELAXED);
+
+		__atomic_fetch_add (&class->contended, 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add (&class->wait_cycles, wait, __ATOMIC_RELAXED);
+		while (wait > max
+				&& !__atomic_compare_exchange_n (&class->max_wait_cycles, &max, wait,
+					false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			continue;
+	}
+	return now;
+}
+
+/* 기다린 시간의 합 내림차순 비교 함수. 같으면 획득 횟수로 비교합니다. */
+/* Orders classes by descending total wait, then acquisitions. */
+static int
+lock_class_compare (const void *a_, const void *b_) {
+	const struct lock_class *a = *(const struct lock_class **) a_;
+	const struct lock_class *b = *(const struct lock_class **) b_;
+
+	if (a->wait_cycles != b->wait_cycles)
+		return a->wait_cycles < b->wait_cycles ? 1 : -1;
+	if (a->acquisitions != b->acquisitions)
+		return a->acquisitions < b->acquisitions ? 1 : -1;
+	return 0;
+}
+
+/* 기다린 시간이 가장 긴 클래스부터 경쟁 통계를 출력합니다. */
+/* Prints contention statistics for the classes that waited
+   longest, if "-lockstat" was given. */
+void
+lockstat_print_stats (void) {
+	static struct lock_class *sorted[LOCK_CLASS_CNT];
+	size_t cnt = 0;
+	size_t i;
+
+	if (!lockstat_enabled)
+		return;
+
+	for (i = 0; i < LOCK_CLASS_CNT; i++)
+		if (lock_classes[i].acquisitions > 0)
+			sorted[cnt++] = &lock_classes[i];
+	qsort (sorted, cnt, sizeof *sorted, lock_class_compare);
+
+	printf ("Lockstat: %-28s %10s %10s %14s %12s %14s\n", "class",
+			"acquired", "contended", "wait", "max wait", "hold");
+	for (i = 0; i < cnt && i < LOCKSTAT_REPORT_MAX; i++) {
+		const struct lock_class *class = sorted[i];
+		const char *name = class->name;
+		const char *p;
+
+		/* 빌드 디렉터리 기준의 "../../" 접두사를 떼어 냅니다. */
+		/* Strip the "../../" that build-relative paths begin with. */
+		while ((p = strstr (name, "../")) != NULL)
+			name = p + 3;
+		printf ("Lockstat: %-28s %10"PRIu64" %10"PRIu64" %14"PRId64" %12"PRId64" %14"PRId64"\n",
+				name, class->acquisitions, class->contended,
+				timer_tsc_to_ns (class->wait_cycles),
+				timer_tsc_to_ns (class->max_wait_cycles),
+				timer_tsc_to_ns (class->hold_cycles));
+	}
+	printf ("Lockstat: times in ns\n");
+}
@@ -2,6 +2,7 @@
 
 #include <debug.h>
 #include <random.h>
+#include <round.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <string.h>
@@ -12,7 +13,9 @@
 #include "threads/intr-stubs.h"
 #include "threads/palloc.h"
 #include "threads/synch.h"
+#include "threads/trace.h"
 #include "threads/vaddr.h"
+#include "devices/timer.h"
 #ifdef USERPROG
 #include "userprog/process.h"
 #endif
@@ -30,16 +33,96 @@
    Do not modify this value. */
 #define THREAD_BASIC 0xd42df210
 
-/* MEMBER */
-#define PRIORITY "priority"
-
-/* THREAD_READY 상태인 프로세스 목록, 즉 실행할 준비는 되었지만 실제로 실행 중이지 않은 프로세스입니다. */
-/* List of processes in THREAD_READY state, that is, processes
-   that are ready to run but not actually running. */
-static struct list ready_list;
-
-static struct list sleep_list;
-static int64_t next_tick_to_awake = NULL;
+/* THREAD_READY 상태인 프로세스 목록, 즉 실행할 준비는 되었지만 실제로 실행 중이지 않은 프로세스입니다.
+   우선순위마다 하나의 FIFO 큐를 두고, ready_mask의 비트 P는 ready_queues[P]가
+   비어 있지 않을 때 설정됩니다. 따라서 삽입은 O(1), 최고 우선순위 검색은
+   비트 스캔 한 번으로 끝납니다. */
+/* Lists of processes in THREAD_READY state, that is, processes
+   that are ready to run but not actually running.  There is one
+   FIFO queue per priority level, and bit P of ready_mask is set
+   whenever ready_queues[P] is non-empty, so enqueueing is O(1)
+   and finding the highest priority is a single bit scan. */
+static struct list ready_queues[PRI_MAX + 1];
+static uint64_t ready_mask;
+static int ready_count;
+
+/* 예산이 남은 EDF 스레드의 준비 목록. 절대 마감 시각 순으로 정렬되며,
+   다른 모든 준비 스레드보다 먼저 실행됩니다. */
+/* Ready EDF threads with budget left, ordered by absolute
+   deadline.  They run ahead of every other ready thread. */
+static struct rb_tree edf_ready;
+
+/* 승인된 EDF 스레드들의 밀도(runtime / deadline) 합, 천분율 단위. */
+/* Sum of the densities (runtime / deadline) of admitted EDF
+   threads, in thousandths. */
+static int edf_total_density;
+
+/* EDF 승인 제어의 상한. 나머지는 일반 스레드를 위해 남겨 둡니다. */
+/* Admission control bound for EDF; the rest of the CPU is left
+   for normal threads. */
+#define EDF_MAX_DENSITY 950
+
+/* 살아 있는 모든 스레드의 목록. 다중 수준 피드백 큐 스케줄러가 1초마다
+   recent_cpu와 우선순위를 다시 계산할 때 사용합니다. */
+/* List of all live threads, used by the multi-level feedback
+   queue scheduler for its once-per-second recomputation. */
+static struct list all_list;
+
+/* 완전 공정 스케줄러(CFS)의 준비 트리. 가상 실행 시간(vruntime) 순으로 정렬되며
+   가장 왼쪽 스레드가 다음에 실행됩니다. */
+/* Ready tree of the completely fair scheduler, ordered by
+   virtual runtime.  The leftmost thread runs next. */
+static struct rb_tree cfs_tree;
+
+/* 준비 트리와 실행 중인 스레드의 vruntime 중 최솟값. 단조 증가합니다. */
+/* Smallest vruntime among the ready tree and the running thread,
+   never moving backward.  Waking threads are placed relative
+   to it. */
+static int64_t cfs_min_vruntime;
+
+/* 보폭(stride) 스케줄러의 준비 트리. pass 값 순으로 정렬됩니다. */
+/* Ready tree of the stride scheduler, ordered by pass. */
+static struct rb_tree stride_tree;
+
+/* 준비 트리와 실행 중인 스레드의 pass 중 최솟값. 새로 들어오는 스레드의 기준입니다. */
+/* Smallest pass among the ready tree and the running thread,
+   never moving backward.  Threads joining the competition start
+   from it. */
+static int64_t stride_global_pass;
+
+/* 보폭 계산에 쓰이는 큰 상수. 티켓 T를 가진 스레드의 보폭은 STRIDE1 / T입니다. */
+/* Large constant for computing strides: a thread holding T
+   tickets advances its pass by STRIDE1 / T per tick. */
+#define STRIDE1 (1 << 20)
+
+/* 우선순위를 기부하는 락 사슬의 최대 길이입니다. */
+/* Longest chain of lock holders that priority is donated along. */
+#define DONATE_DEPTH_MAX 8
+
+/* nice 0 스레드가 한 틱 동안 실행될 때 증가하는 vruntime. */
+/* vruntime charged to a nice-0 thread for one tick. */
+#define CFS_TICK 1024
+#define CFS_NICE_0_WEIGHT 1024
+
+/* nice -20..20에 대한 가중치. nice가 1 증가할 때마다 약 1.25배씩 줄어듭니다. */
+/* Weights for nice -20 to 20.  Each step of nice changes the
+   weight by about 1.25x, so one nice level is worth about 10%
+   of CPU time against a competing thread. */
+static const int cfs_nice_weight[41] = {
+    /* -20 */ 88761, 71755, 56483, 46273, 36291,
+    /* -15 */ 29154, 23254, 18705, 14949, 11916,
+    /* -10 */ 9548,  7620,  6100,  4904,  3906,
+    /*  -5 */ 3121,  2501,  1991,  1586,  1277,
+    /*   0 */ 1024,  820,   655,   526,   423,
+    /*   5 */ 335,   272,   215,   172,   137,
+    /*  10 */ 110,   87,    70,    56,    45,
+    /*  15 */ 36,    29,    23,    18,    15,
+    /*  20 */ 12,
+};
+
+/* 시스템 부하 평균 (17.14 고정 소수점). */
+/* System load average, in 17.14 fixed point. */
+static fixed_t load_avg;
 
 /* 유휴 스레드. */
 /* Idle thread. */
@@ -57,6 +140,37 @@ static struct lock tid_lock;
 /* Thread destruction requests */
 static struct list destruction_req;
 
+/* 재사용을 기다리는 빈 페이지의 스택. 페이지의 첫 워드로 서로 연결됩니다.
+   thread_create()가 흔한 경우에 페이지 할당자의 풀 락과 페이지 0 채우기를
+   건너뛸 수 있게 합니다. */
+/* Stack of free pages kept for reuse, linked through their first
+   word.  Lets thread_create() skip the page allocator's pool
+   lock and the zeroing of a fresh page on the common path. */
+struct page_cache {
+    void *top;                  /* Most recently freed page, or NULL. */
+    int cnt;                    /* Number of cached pages. */
+};
+
+/* 캐시마다 보관하는 최대 페이지 수. 나머지는 페이지 할당자로 돌려줍니다. */
+/* Most pages kept per cache; the rest go back to the page
+   allocator. */
+#define PAGE_CACHE_MAX 16
+
+/* 죽은 스레드의 스레드 페이지. struct thread는 init_thread()가 다시 채우고
+   스택은 초기화할 필요가 없으므로 그대로 재사용합니다. */
+/* Thread pages of dead threads.  init_thread() reinitializes
+   struct thread and the stack needs no clearing, so they are
+   reused as they are. */
+static struct page_cache thread_page_cache;
+
+/* 종료한 프로세스의 파일 디스크립터 테이블 페이지. process_exit()가 모든 파일을
+   닫은 뒤이므로 (연결에 쓰인 첫 항목을 빼면) 모든 항목이 이미 NULL입니다. */
+/* File descriptor table pages of exited processes.  They are
+   returned after process_exit() has closed every file, so all
+   entries but the first, which links the stack, are already
+   NULL. */
+static struct page_cache fdt_page_cache;
+
 /* 통계. */
 /* Statistics. */
 static long long idle_ticks; /* 유휴 상태에서 보낸 타이머 틱 수. */       /* # of timer ticks spent idle. */
@@ -76,7 +190,22 @@ static unsigned thread_ticks; /* 마지막 yield 이후 타이머 틱 수. */ /*
    Controlled by kernel command-line option "-o mlfqs". */
 bool thread_mlfqs;
 
+/* true이면 가상 실행 시간 기반의 완전 공정 스케줄러를 사용합니다.
+   커널 명령 줄 옵션 "-cfs"에 의해 제어됩니다. */
+/* If true, use the completely fair (virtual runtime) scheduler.
+   Controlled by kernel command-line option "-cfs". */
+bool thread_cfs;
+
+/* true이면 티켓 비율로 CPU를 나누는 보폭 스케줄러를 사용합니다.
+   커널 명령 줄 옵션 "-stride"에 의해 제어됩니다. */
+/* If true, use the stride scheduler, which shares the CPU in
+   proportion to tickets.
+   Controlled by kernel command-line option "-stride". */
+bool thread_stride;
+
 static void kernel_thread(thread_func *, void *aux);
+static void thread_entry(void) NO_RETURN;
+void thread_switch(uint64_t *cur_rsp, uint64_t next_rsp);
 
 static void idle(void *aux UNUSED);
 static struct thread *next_thread_to_run(void);
@@ -84,8 +213,28 @@ static void init_thread(struct thread *, const char *name, int priority);
 static void do_schedule(int status);
 static void schedule(void);
 static tid_t allocate_tid(void);
-void thread_sleep(int64_t ticks);
-void thread_wakeup(int64_t ticks);
+static void ready_queue_push(struct thread *);
+static void ready_queue_remove(struct thread *);
+static struct thread *ready_queue_pop(void);
+static int ready_queue_max_priority(void);
+static bool ready_queue_preempts(struct thread *);
+static void page_cache_init(struct page_cache *);
+static void *page_cache_get(struct page_cache *);
+static bool page_cache_put(struct page_cache *, void *page);
+static bool cfs_less(const struct rb_elem *, const struct rb_elem *, void *);
+static void cfs_tick(struct thread *);
+static void cfs_update_min_vruntime(void);
+static bool stride_less(const struct rb_elem *, const struct rb_elem *, void *);
+static void stride_tick(struct thread *);
+static void stride_update_global_pass(void);
+static void stride_donate(struct thread *, int delta);
+static bool thread_update_priority(struct thread *);
+static bool edf_active(const struct thread *);
+static bool edf_less(const struct rb_elem *, const struct rb_elem *, void *);
+static void edf_replenish(void *t_);
+static void mlfqs_tick(struct thread *);
+static void mlfqs_update_priority(struct thread *);
+static void mlfqs_recalculate(void);
 
 /* T가 유효한 스레드를 가리키는지 확인합니다. */
 /* Returns true if T appears to point to a valid thread. */
@@ -147,9 +296,16 @@ void thread_init(void) {
     /* 전역 스레드 컨텍스트 초기화 */
     /* Init the globla thread context */
     lock_init(&tid_lock);
-    list_init(&ready_list);
-    list_init(&sleep_list);
+    for (int i = PRI_MIN; i <= PRI_MAX; i++)
+        list_init(&ready_queues[i]);
+    ready_mask = 0;
+    list_init(&all_list);
+    rb_init(&cfs_tree, cfs_less, NULL);
+    rb_init(&stride_tree, stride_less, NULL);
+    rb_init(&edf_ready, edf_less, NULL);
     list_init(&destruction_req);
+    page_cache_init(&thread_page_cache);
+    page_cache_init(&fdt_page_cache);
 
     /* 실행 중인 스레드를 위한 스레드 구조체 설정 */
     /* Set up a thread structure for the running thread. */
@@ -159,7 +315,12 @@ void thread_init(void) {
     initial_thread->tid = allocate_tid();
 }
 
-// 스레드를 sleep 시켜서 sleep_list에 넣습니다.
+static void thread_sleep_expired(void *t_);
+
+/* 현재 스레드를 약 TICKS 틱 동안 재웁니다. 깨우기는 타이머 휠의 콜아웃이 담당합니다. */
+/* Puts the current thread to sleep for about TICKS timer ticks.
+   The wakeup is a callout on the timer wheel, so neither sleeping
+   nor the timer tick scans the other sleeping threads. */
 void thread_sleep(int64_t ticks) {
     struct thread *curr = thread_current();
     enum intr_level old_level;
@@ -167,42 +328,23 @@ void thread_sleep(int64_t ticks) {
     old_level = intr_disable();
 
     if (curr != idle_thread) {
-        curr->wakeup_ticks = ticks;
-        list_push_front(&sleep_list, &curr->elem);
-        next_awake_ticks(curr->wakeup_ticks);
+        timer_add(&curr->sleep_callout, ticks, thread_sleep_expired, curr);
         thread_block();
     }
 
     intr_set_level(old_level);
 }
 
-// 깨어날 thread wakeup_ticks 중에서 작거나 같은 것을 wakeup_ticks를 업데이트
-void next_awake_ticks(int64_t ticks) {
-    if (next_tick_to_awake == NULL)
-        next_tick_to_awake = ticks;
-    if (ticks < next_tick_to_awake)
-        next_tick_to_awake = ticks;
-}
-
-// 일어날 시간이 되면 대기 큐에 업데이트 후 sleep_list에서 remove
-void thread_wakeup(int64_t ticks) {
-    struct list_elem *e = list_begin(&sleep_list);  // sleep_list 시작부터 순회
-    
-    if (ticks < next_tick_to_awake)
-        return;
+/* 타이머 인터럽트 컨텍스트에서 잠든 스레드 T를 깨웁니다. */
+/* Timer callout that wakes sleeping thread T.  Runs in the timer
+   interrupt, so preemption is requested on return if T should
+   run instead of the running thread. */
+static void thread_sleep_expired(void *t_) {
+    struct thread *t = t_;
 
-    while (e != list_end(&sleep_list))  // sleep_list에 마지막까지 봄
-    {
-        struct thread *t = list_entry(e, struct thread, elem);
-
-        if (t->wakeup_ticks <= ticks) {
-            e = list_remove(e);
-            thread_unblock(t);
-        }
-        else {
-            e = list_next(e);
-        }
-    }
+    thread_unblock(t);
+    if (intr_context() && ready_queue_preempts(thread_current()))
+        intr_yield_on_return();
 }
 
 /* 선점형 스레드 스케줄링을 시작하기 위해 인터럽트를 활성화합니다.
@@ -243,10 +385,43 @@ void thread_tick(void) {
     else
         kernel_ticks++;
 
-    /* 선점 강제 실행 */
-    /* Enforce preemption. */
-    if (++thread_ticks >= TIME_SLICE)
+    if (thread_mlfqs)
+        mlfqs_tick(t);
+    else if (thread_cfs)
+        cfs_tick(t);
+    else if (thread_stride)
+        stride_tick(t);
+
+    /* EDF 예산을 다 쓰면 다음 주기까지 일반 스레드로 내려갑니다. */
+    /* An EDF thread that exhausts its budget drops to its normal
+       class until the next period replenishes it. */
+    if (edf_active(t) && --t->edf_budget == 0)
         intr_yield_on_return();
+
+    /* 선점 강제 실행. CFS와 보폭 스케줄러에서는 TIME_SLICE가 최소 실행 단위이며,
+       더 작은 vruntime이나 pass를 가진 스레드가 있을 때만 양보합니다. */
+    /* Enforce preemption.  Under CFS and the stride scheduler,
+       TIME_SLICE is the minimum granularity: the thread only gives
+       way once a ready thread has fallen behind it in vruntime or
+       pass. */
+    if (++thread_ticks >= TIME_SLICE && ((!thread_cfs && !thread_stride) || ready_queue_preempts(t)))
+        intr_yield_on_return();
+}
+
+/* 유휴 스레드가 멈춰 있는 동안 타이머 인터럽트 없이 지나간 틱 하나를
+   처리합니다. 유휴 스레드에 대해 thread_tick()이 했을 일 중 선점을 뺀 나머지,
+   즉 통계와 MLFQS의 1초마다 재계산을 합니다. 인터럽트가 꺼져 있어야 합니다. */
+/* Accounts for one timer tick that passed without an interrupt
+   while the idle thread was halted.  Does what thread_tick()
+   would have done for the idle thread, apart from preemption:
+   the statistics and the once-per-second MLFQS recomputation.
+   Interrupts must be off. */
+void thread_idle_tick(void) {
+    ASSERT(intr_get_level() == INTR_OFF);
+
+    idle_ticks++;
+    if (thread_mlfqs && timer_ticks() % TIMER_FREQ == 0)
+        mlfqs_recalculate();
 }
 
 /* 스레드 통계를 출력합니다. */
@@ -286,15 +461,32 @@ void thread_print_stats(void) {
    Priority scheduling is the goal of Problem 1-3. */
 tid_t thread_create(const char *name, int priority, thread_func *function, void *aux) {
     struct thread *t;
+    struct file **fdt;
+    uint64_t *sp;
     tid_t tid;
+    int i;
 
     ASSERT(function != NULL);
 
-    /* 스레드 할당. */
-    /* Allocate thread. */
-    t = palloc_get_page(PAL_ZERO);
-    if (t == NULL) {
-        palloc_free_page(t);
+    /* 스레드 할당. 캐시에 죽은 스레드의 페이지가 있으면 그것을 씁니다. */
+    /* Allocate thread, reusing a dead thread's page if one is
+       cached. */
+    t = page_cache_get(&thread_page_cache);
+    if (t == NULL)
+        t = palloc_get_page(PAL_ZERO);
+    if (t == NULL)
+        return TID_ERROR;
+
+    /* 파일 디스크립터 테이블 할당. init_thread()가 T를 all_list에 넣기 전에
+       할당하므로, 실패해도 T는 어떤 리스트에도 들어 있지 않습니다. */
+    /* Allocate the file descriptor table before init_thread() puts
+       T on all_list, so that on failure T is on no list yet. */
+    fdt = page_cache_get(&fdt_page_cache);
+    if (fdt == NULL)
+        fdt = palloc_get_page(PAL_ZERO);
+    if (fdt == NULL) {
+        if (!page_cache_put(&thread_page_cache, t))
+            palloc_free_page(t);
         return TID_ERROR;
     }
 
@@ -303,6 +495,25 @@ tid_t thread_create(const char *name, int priority, thread_func *function, void
     init_thread(t, name, priority);
     tid = t->tid = allocate_tid();
 
+    /* 다중 수준 피드백 큐 스케줄러에서는 부모의 nice와 recent_cpu를 물려받고
+       우선순위는 그로부터 계산합니다. */
+    /* Under the MLFQS, the child inherits its parent's nice and
+       recent_cpu, and its priority is derived from them. */
+    if (thread_mlfqs) {
+        struct thread *curr = thread_current();
+        t->nice = curr->nice;
+        t->recent_cpu = curr->recent_cpu;
+        mlfqs_update_priority(t);
+    }
+
+    /* CFS에서 새 스레드는 현재 최소 vruntime에서 시작합니다. */
+    /* Under CFS, a new thread starts at the current minimum
+       vruntime, so it neither starves nor monopolizes the CPU. */
+    if (thread_cfs)
+        t->vruntime = cfs_min_vruntime;
+    if (thread_stride)
+        t->pass = stride_global_pass;
+
     /* kernel_thread 호출 시 스케줄링됩니다.
      * 주의) rdi는 첫 번째 인자이며, rsi는 두 번째 인자입니다. */
     /* Call the kernel_thread if it scheduled.
@@ -316,13 +527,20 @@ tid_t thread_create(const char *name, int priority, thread_func *function, void
     t->tf.cs = SEL_KCSEG;
     t->tf.eflags = FLAG_IF;
 
+    /* 첫 thread_switch()가 thread_entry()로 "반환"하도록 스택을 준비합니다.
+       호출 직후처럼 rsp가 정렬되도록 가짜 반환 주소를 하나 둡니다. */
+    /* Prepare the stack so that the first thread_switch() into T
+       "returns" to thread_entry(), with a dummy return address
+       above it so rsp is aligned as on entry to any function. */
+    sp = (uint64_t *)((uint8_t *)t + PGSIZE);
+    *--sp = 0;                          /* thread_entry()'s return address. */
+    *--sp = (uint64_t)thread_entry;     /* thread_switch()'s return address. */
+    for (i = 0; i < 6; i++)
+        *--sp = 0;                      /* rbx, rbp, r12-r15. */
+    t->switch_rsp = (uint64_t)sp;
+
     // for project 2 sys call
-    // t->fdt = palloc_get_multiple(PAL_ZERO, 256);
-    t->fdt = palloc_get_page(PAL_ZERO); // 4KB 메모리를 할당 (한 페이지의 크기, 파일 테이블에 1개의 페이지를 할당한다.)
-    if (t->fdt == NULL) {
-        palloc_free_page(t); 
-        return TID_ERROR;
-    }
+    t->fdt = fdt;
     t->fd_idx = 3;
     t->fdt[0] = NULL;
     t->fdt[1] = NULL;
@@ -384,47 +602,45 @@ void thread_unblock(struct thread *t) {
 
     old_level = intr_disable();
     ASSERT(t->status == THREAD_BLOCKED);
-    // list_push_back(&ready_list, &t->elem);
-    list_insert_desc_ordered(&ready_list, &t->elem, less_priority, PRIORITY);
-    t->status = THREAD_READY;
-    intr_set_level(old_level);
-}
-
-/* 값 비교. t1의 우선순위가 낮은 경우 true*/
-bool less_priority(struct list_elem *e1, struct list_elem *e2, void *aux) {
-    struct thread *t1 = list_entry(e1, struct thread, elem);
-    struct thread *t2 = list_entry(e2, struct thread, elem);
-    int t1_priority = t1->priority;
-    int t2_priority = t2->priority;
 
-    if (t1_priority < t2_priority) {
-        return true;
-    }
-    return false;
-}
-/* 값 비교. t1의 우선순위가 낮은 경우 false*/
-bool more_priority(struct list_elem *e1, struct list_elem *e2, void *aux) {
-    struct thread *t1 = list_entry(e1, struct thread, elem);
-    struct thread *t2 = list_entry(e2, struct thread, elem);
-    int t1_priority = t1->priority;
-    int t2_priority = t2->priority;
+    /* 잠들었던 스레드가 밀린 vruntime으로 CPU를 독점하지 않도록,
+       최소 vruntime에서 한 TIME_SLICE 이상 뒤처지지 않게 합니다. */
+    /* Keep a thread that slept from monopolizing the CPU with the
+       vruntime it missed: it may lag the minimum by at most one
+       TIME_SLICE. */
+    if (thread_cfs && t->vruntime < cfs_min_vruntime - TIME_SLICE * CFS_TICK)
+        t->vruntime = cfs_min_vruntime - TIME_SLICE * CFS_TICK;
+    /* 보폭 스케줄러에서도 잠든 동안의 pass를 몰아서 쓰지 못하게 합니다. */
+    /* Likewise, a thread may not bank pass while blocked under
+       the stride scheduler. */
+    if (thread_stride && t->pass < stride_global_pass)
+        t->pass = stride_global_pass;
+    ready_queue_push(t);
+    t->status = THREAD_READY;
 
-    if (t1_priority > t2_priority) {
-        return true;
-    }
-    return false;
+    /* EDF 스레드는 인터럽트 핸들러에서 깨어나면 즉시 선점합니다. */
+    /* An EDF thread woken from an interrupt handler preempts as
+       soon as the handler returns. */
+    if (edf_active(t) && intr_context() && ready_queue_preempts(thread_current()))
+        intr_yield_on_return();
+    intr_set_level(old_level);
 }
 
 // 우선순위 스케줄링 하는 함수
 void test_max_priority(void) {
     struct thread *curr = thread_current();
-    struct list_elem *highest_elem = list_begin(&ready_list);
-    if (list_end(&ready_list) == (highest_elem)) {
-        return;
-    }
-    // 인터럽트 컨텍스트가 아니고, 현재 스레드의 우선순위가 준비 리스트의 최고 우선순위 스레드보다 낮다면
-    if (!intr_context() && less_priority(&curr->elem, highest_elem, NULL)) {
-        thread_yield();
+    enum intr_level old_level = intr_disable();
+    bool preempt = ready_queue_preempts(curr);
+    intr_set_level(old_level);
+
+    // 준비 큐에 현재 스레드보다 먼저 실행되어야 할 스레드가 있다면 양보한다.
+    // 인터럽트 컨텍스트에서는 핸들러가 반환할 때 양보하므로, 인터럽트가 깨운
+    // 스레드(디스크 완료, 작업 큐 워커 등)가 다음 타임 슬라이스까지 기다리지 않는다.
+    if (preempt) {
+        if (intr_context())
+            intr_yield_on_return();
+        else
+            thread_yield();
     }
 }
 
@@ -478,7 +694,10 @@ void thread_exit(void) {
        schedule_tail() 호출 중에 파괴됩니다. */
     /* Just set our status to dying and schedule another process.
        We will be destroyed during the call to schedule_tail(). */
+    thread_clear_edf();
+    malloc_thread_exit();  // 매거진에 남은 블록 반환
     intr_disable();
+    list_remove(&thread_current()->all_elem);
     do_schedule(THREAD_DYING);
     NOT_REACHED();
 }
@@ -495,8 +714,7 @@ void thread_yield(void) {
     
     old_level = intr_disable();
     if (curr != idle_thread) {
-        // list_push_back(&ready_list, &curr->elem);
-        list_insert_desc_ordered(&ready_list, &curr->elem, less_priority, PRIORITY);
+        ready_queue_push(curr);
     }
     do_schedule(THREAD_READY);
     intr_set_level(old_level);
@@ -505,9 +723,19 @@ void thread_yield(void) {
 /* 현재 스레드의 우선순위를 NEW_PRIORITY로 설정합니다. */
 /* Sets the current thread's priority to NEW_PRIORITY. */
 void thread_set_priority(int new_priority) {
-    thread_current()->init_priority = new_priority;
+    struct thread *curr = thread_current();
+    enum intr_level old_level;
+
+    /* 다중 수준 피드백 큐 스케줄러는 우선순위를 스스로 결정합니다. */
+    /* The MLFQS computes priorities itself. */
+    if (thread_mlfqs)
+        return;
+
+    old_level = intr_disable();
+    curr->init_priority = new_priority;
+    thread_update_priority(curr);
+    intr_set_level(old_level);
 
-    refresh_priority();
     test_max_priority();
 }
 
@@ -517,31 +745,362 @@ int thread_get_priority(void) {
     return thread_current()->priority;
 }
 
+/* 현재 스레드의 기본 티켓 수를 TICKETS로 설정합니다. */
+/* Sets the running thread's base ticket count to TICKETS.  Under
+   the stride scheduler the thread's CPU share is proportional to
+   its tickets plus any tickets donated to it. */
+void thread_set_tickets(int tickets) {
+    struct thread *curr = thread_current();
+    enum intr_level old_level;
+
+    ASSERT(TICKETS_MIN <= tickets && tickets <= TICKETS_MAX);
+
+    old_level = intr_disable();
+    curr->tickets += tickets - curr->init_tickets;
+    curr->init_tickets = tickets;
+    intr_set_level(old_level);
+
+    test_max_priority();
+}
+
+/* 현재 스레드의 (기부받은 것을 포함한) 티켓 수를 반환합니다. */
+/* Returns the running thread's tickets, including donations. */
+int thread_get_tickets(void) {
+    return thread_current()->tickets;
+}
+
 /* 현재 스레드의 nice 값을 NICE로 설정합니다. */
 /* Sets the current thread's nice value to NICE. */
-void thread_set_nice(int nice UNUSED) {
-    /* TODO: Your implementation goes here */
+void thread_set_nice(int nice) {
+    struct thread *curr = thread_current();
+    enum intr_level old_level;
+
+    ASSERT(-20 <= nice && nice <= 20);
+
+    old_level = intr_disable();
+    curr->nice = nice;
+    if (thread_mlfqs)
+        mlfqs_update_priority(curr);
+    intr_set_level(old_level);
+
+    test_max_priority();
 }
 
 /* 현재 스레드의 nice 값을 반환합니다. */
 /* Returns the current thread's nice value. */
 int thread_get_nice(void) {
-    /* TODO: Your implementation goes here */
-    return 0;
+    return thread_current()->nice;
 }
 
 /* 시스템 로드 평균의 100배를 반환합니다. */
 /* Returns 100 times the system load average. */
 int thread_get_load_avg(void) {
-    /* TODO: Your implementation goes here */
-    return 0;
+    enum intr_level old_level = intr_disable();
+    int load = fp_round(fp_mul_int(load_avg, 100));
+    intr_set_level(old_level);
+    return load;
 }
 
 /* 현재 스레드의 recent_cpu 값의 100배를 반환합니다. */
 /* Returns 100 times the current thread's recent_cpu value. */
 int thread_get_recent_cpu(void) {
-    /* TODO: Your implementation goes here */
-    return 0;
+    enum intr_level old_level = intr_disable();
+    int recent = fp_round(fp_mul_int(thread_current()->recent_cpu, 100));
+    intr_set_level(old_level);
+    return recent;
+}
+
+/* 현재 스레드를 EDF 클래스로 옮깁니다. 매 PERIOD 틱마다 새 작업이 시작되며,
+   각 작업은 시작 후 DEADLINE 틱 안에 최대 RUNTIME 틱의 CPU를 보장받습니다.
+   승인 제어를 통과하지 못하면 false를 반환하고 아무것도 바꾸지 않습니다. */
+/* Moves the running thread into the earliest-deadline-first
+   class.  A new job is released every PERIOD ticks, and each job
+   is guaranteed up to RUNTIME ticks of CPU within DEADLINE ticks
+   of its release.  Requires RUNTIME <= DEADLINE <= PERIOD.
+
+   Returns false, changing nothing, if admitting the thread would
+   push the summed density of EDF threads past EDF_MAX_DENSITY. */
+bool thread_set_edf(int64_t runtime, int64_t period, int64_t deadline) {
+    struct thread *curr = thread_current();
+    enum intr_level old_level;
+    int density;
+
+    ASSERT(0 < runtime && runtime <= deadline && deadline <= period);
+
+    density = DIV_ROUND_UP(runtime * 1000, deadline);
+
+    old_level = intr_disable();
+    if (edf_total_density - curr->edf_density + density > EDF_MAX_DENSITY) {
+        intr_set_level(old_level);
+        return false;
+    }
+    if (curr->edf)
+        timer_cancel(&curr->edf_callout);
+    edf_total_density += density - curr->edf_density;
+
+    curr->edf = true;
+    curr->edf_waiting = false;
+    curr->edf_density = density;
+    curr->edf_runtime = runtime;
+    curr->edf_period = period;
+    curr->edf_deadline = deadline;
+    curr->edf_abs_deadline = timer_ticks() + deadline;
+    curr->edf_budget = runtime;
+    curr->edf_misses = 0;
+    timer_add(&curr->edf_callout, period, edf_replenish, curr);
+    intr_set_level(old_level);
+
+    return true;
+}
+
+/* 현재 스레드를 EDF 클래스에서 빼고, 차지하던 밀도를 반환합니다. */
+/* Removes the running thread from the EDF class, if it is in it,
+   and gives back its share of the admission bound. */
+void thread_clear_edf(void) {
+    struct thread *curr = thread_current();
+    enum intr_level old_level = intr_disable();
+
+    if (curr->edf) {
+        timer_cancel(&curr->edf_callout);
+        edf_total_density -= curr->edf_density;
+        curr->edf_density = 0;
+        curr->edf = false;
+    }
+    intr_set_level(old_level);
+}
+
+/* 현재 작업을 마치고 다음 주기의 작업이 시작될 때까지 잠듭니다.
+   마감 시각을 넘겨 끝났다면 마감 실패로 셉니다. */
+/* Completes the running EDF thread's current job and sleeps
+   until the next one is released.  Finishing after the job's
+   absolute deadline counts as a deadline miss. */
+void thread_edf_wait_period(void) {
+    struct thread *curr = thread_current();
+    enum intr_level old_level;
+
+    ASSERT(curr->edf);
+
+    old_level = intr_disable();
+    if (timer_ticks() > curr->edf_abs_deadline)
+        curr->edf_misses++;
+    curr->edf_waiting = true;
+    thread_block();
+    intr_set_level(old_level);
+}
+
+/* 현재 스레드가 EDF 클래스에 들어온 뒤 놓친 마감 횟수를 반환합니다. */
+/* Returns the number of deadlines the running thread has missed
+   since it entered the EDF class. */
+int thread_edf_misses(void) {
+    return thread_current()->edf_misses;
+}
+
+/* 매 주기마다 타이머 인터럽트에서 실행되어 EDF 스레드 T의 다음 작업을 시작합니다.
+   이전 작업이 끝나지 않았다면 마감 실패로 셉니다. */
+/* Timer callout, once per period: releases EDF thread T's next
+   job with a fresh budget and deadline.  If the previous job has
+   not completed, its deadline has passed, so it counts as a
+   miss. */
+static void edf_replenish(void *t_) {
+    struct thread *t = t_;
+    bool requeue = t->status == THREAD_READY;
+
+    if (!t->edf_waiting)
+        t->edf_misses++;
+
+    /* 준비 큐는 예산 유무와 마감 시각에 따라 나뉘므로 다시 넣어야 합니다. */
+    /* Which ready queue T is on depends on its budget and
+       deadline, so requeue it around the update. */
+    if (requeue)
+        ready_queue_remove(t);
+    t->edf_abs_deadline = timer_ticks() + t->edf_deadline;
+    t->edf_budget = t->edf_runtime;
+    if (requeue)
+        ready_queue_push(t);
+
+    timer_add(&t->edf_callout, t->edf_period, edf_replenish, t);
+
+    if (t->edf_waiting) {
+        t->edf_waiting = false;
+        thread_unblock(t);
+    }
+    if (intr_context() && ready_queue_preempts(thread_current()))
+        intr_yield_on_return();
+}
+
+/* T가 예산이 남은 EDF 스레드이면 true를 반환합니다. */
+/* Returns true if T is an EDF thread with budget left. */
+static bool edf_active(const struct thread *t) {
+    return t->edf && t->edf_budget > 0;
+}
+
+/* 절대 마감 시각 비교 함수. */
+/* Orders edf_ready by absolute deadline. */
+static bool edf_less(const struct rb_elem *a_, const struct rb_elem *b_, void *aux UNUSED) {
+    const struct thread *a = rb_entry(a_, struct thread, tree_elem);
+    const struct thread *b = rb_entry(b_, struct thread, tree_elem);
+
+    return a->edf_abs_deadline < b->edf_abs_deadline;
+}
+
+/* 다중 수준 피드백 큐 스케줄러의 틱 처리입니다. 틱마다 실행 중인 스레드의
+   recent_cpu만 증가하므로, 4틱마다는 그 스레드의 우선순위만 다시 계산합니다.
+   모든 스레드의 값이 바뀌는 것은 1초마다 recent_cpu가 감쇠할 때뿐입니다. */
+/* MLFQS work for one timer tick.  Only the running thread's
+   recent_cpu changes from tick to tick, so every fourth tick only
+   its priority is recomputed; every thread is revisited only once
+   per second, when recent_cpu decays. */
+static void mlfqs_tick(struct thread *curr) {
+    int64_t now = timer_ticks();
+
+    if (curr != idle_thread)
+        curr->recent_cpu = fp_add_int(curr->recent_cpu, 1);
+
+    if (now % TIMER_FREQ == 0)
+        mlfqs_recalculate();
+    else if (now % 4 == 0)
+        mlfqs_update_priority(curr);
+
+    if (ready_queue_preempts(curr))
+        intr_yield_on_return();
+}
+
+/* CFS의 틱 처리입니다. 실행 중인 스레드에 가중치에 반비례하는 vruntime을 부과합니다. */
+/* CFS work for one timer tick: charges the running thread
+   vruntime inversely proportional to its weight. */
+static void cfs_tick(struct thread *curr) {
+    if (curr == idle_thread)
+        return;
+    curr->vruntime += (int64_t) CFS_TICK * CFS_NICE_0_WEIGHT / cfs_nice_weight[curr->nice + 20];
+    cfs_update_min_vruntime();
+}
+
+/* cfs_min_vruntime을 준비 트리의 가장 왼쪽 스레드와 실행 중인 스레드에 맞춰 올립니다. */
+/* Advances cfs_min_vruntime to the smaller of the running
+   thread's and the leftmost ready thread's vruntime. */
+static void cfs_update_min_vruntime(void) {
+    struct thread *curr = running_thread();
+    struct rb_elem *min = rb_min(&cfs_tree);
+    int64_t vruntime;
+    bool valid = false;
+
+    if (curr != idle_thread && curr->status == THREAD_RUNNING) {
+        vruntime = curr->vruntime;
+        valid = true;
+    }
+    if (min != NULL) {
+        int64_t leftmost = rb_entry(min, struct thread, tree_elem)->vruntime;
+        if (!valid || leftmost < vruntime)
+            vruntime = leftmost;
+        valid = true;
+    }
+    if (valid && vruntime > cfs_min_vruntime)
+        cfs_min_vruntime = vruntime;
+}
+
+/* 보폭 스케줄러의 틱 처리입니다. 실행 중인 스레드의 pass를 보폭만큼 올립니다. */
+/* Stride scheduler work for one timer tick: advances the
+   running thread's pass by its stride. */
+static void stride_tick(struct thread *curr) {
+    if (curr == idle_thread)
+        return;
+    curr->pass += STRIDE1 / curr->tickets;
+    stride_update_global_pass();
+}
+
+/* stride_global_pass를 준비 트리의 가장 왼쪽 스레드와 실행 중인 스레드에 맞춰 올립니다. */
+/* Advances stride_global_pass to the smaller of the running
+   thread's and the leftmost ready thread's pass. */
+static void stride_update_global_pass(void) {
+    struct thread *curr = running_thread();
+    struct rb_elem *min = rb_min(&stride_tree);
+    int64_t pass = 0;
+    bool valid = false;
+
+    if (curr != idle_thread && curr->status == THREAD_RUNNING) {
+        pass = curr->pass;
+        valid = true;
+    }
+    if (min != NULL) {
+        int64_t leftmost = rb_entry(min, struct thread, tree_elem)->pass;
+        if (!valid || leftmost < pass)
+            pass = leftmost;
+        valid = true;
+    }
+    if (valid && pass > stride_global_pass)
+        stride_global_pass = pass;
+}
+
+/* pass 순서 비교 함수. 같으면 먼저 들어온 스레드가 앞에 옵니다. */
+/* Orders the stride ready tree by pass.  Ties keep FIFO order. */
+static bool stride_less(const struct rb_elem *a_, const struct rb_elem *b_, void *aux UNUSED) {
+    const struct thread *a = rb_entry(a_, struct thread, tree_elem);
+    const struct thread *b = rb_entry(b_, struct thread, tree_elem);
+
+    return a->pass < b->pass;
+}
+
+/* vruntime 순서 비교 함수. 같으면 먼저 들어온 스레드가 앞에 옵니다. */
+/* Orders the CFS ready tree by vruntime.  Ties keep FIFO order. */
+static bool cfs_less(const struct rb_elem *a_, const struct rb_elem *b_, void *aux UNUSED) {
+    const struct thread *a = rb_entry(a_, struct thread, tree_elem);
+    const struct thread *b = rb_entry(b_, struct thread, tree_elem);
+
+    return a->vruntime < b->vruntime;
+}
+
+/* T의 우선순위를 recent_cpu와 nice로부터 다시 계산합니다.
+   T가 준비 상태라면 새 우선순위의 큐로 옮깁니다. 인터럽트가 꺼져 있어야 합니다. */
+/* Recomputes T's priority from its recent_cpu and nice, moving
+   it to the matching ready queue if it is ready.  Interrupts
+   must be off. */
+static void mlfqs_update_priority(struct thread *t) {
+    int priority;
+
+    ASSERT(intr_get_level() == INTR_OFF);
+
+    if (t == idle_thread)
+        return;
+
+    priority = PRI_MAX - fp_to_int(fp_div_int(t->recent_cpu, 4)) - t->nice * 2;
+    if (priority < PRI_MIN)
+        priority = PRI_MIN;
+    else if (priority > PRI_MAX)
+        priority = PRI_MAX;
+
+    if (priority == t->priority)
+        return;
+    if (t->status == THREAD_READY) {
+        ready_queue_remove(t);
+        t->priority = priority;
+        ready_queue_push(t);
+    } else
+        t->priority = priority;
+    synch_priority_changed(t);
+}
+
+/* 1초마다 load_avg를 갱신하고 모든 스레드의 recent_cpu를 감쇠시킨 뒤
+   우선순위를 다시 계산합니다. */
+/* Once per second: updates load_avg, then decays every thread's
+   recent_cpu and recomputes its priority. */
+static void mlfqs_recalculate(void) {
+    struct thread *curr = running_thread();
+    int ready_threads = ready_count + (curr != idle_thread ? 1 : 0);
+    fixed_t decay;
+    struct list_elem *e;
+
+    load_avg = fp_add(fp_div_int(fp_mul_int(load_avg, 59), 60),
+                      fp_div_int(fp_from_int(ready_threads), 60));
+
+    decay = fp_div(fp_mul_int(load_avg, 2), fp_add_int(fp_mul_int(load_avg, 2), 1));
+    for (e = list_begin(&all_list); e != list_end(&all_list); e = list_next(e)) {
+        struct thread *t = list_entry(e, struct thread, all_elem);
+
+        if (t == idle_thread)
+            continue;
+        t->recent_cpu = fp_add_int(fp_mul(decay, t->recent_cpu), t->nice);
+        mlfqs_update_priority(t);
+    }
 }
 
 /* 유휴 스레드입니다. 다른 스레드가 실행 준비가 되어 있지 않을 때 실행됩니다.
@@ -573,6 +1132,19 @@ static void idle(void *idle_started_ UNUSED) {
         intr_disable();
         thread_block();
 
+        /* 준비된 스레드가 없는 동안 PAL_ZERO 요청에 대비해 빈 페이지를 미리
+           0으로 채웁니다. 인터럽트를 켜 두므로 새로 준비된 스레드는 한 페이지
+           안에 알아챕니다. */
+        /* While no thread is ready, zero free pages ahead of
+           PAL_ZERO requests.  Interrupts stay on, so a thread that
+           becomes ready is noticed within one page. */
+        intr_enable();
+        while (ready_count == 0 && palloc_zero_idle())
+            continue;
+        intr_disable();
+        if (ready_count > 0)
+            continue;
+
         /* 인터럽트를 다시 활성화하고 다음 인터럽트를 기다립니다.
 
             'sti' 명령은 다음 명령의 완료까지 인터럽트를 비활성화하므로,
@@ -593,6 +1165,7 @@ static void idle(void *idle_started_ UNUSED) {
 
            See [IA32-v2a] "HLT", [IA32-v2b] "STI", and [IA32-v3a]
            7.11.1 "HLT Instruction". */
+        timer_idle_enter();
         asm volatile("sti; hlt" : : : "memory");
     }
 }
@@ -611,6 +1184,8 @@ static void kernel_thread(thread_func *function, void *aux) {
 /* Does basic initialization of T as a blocked thread named
    NAME. */
 static void init_thread(struct thread *t, const char *name, int priority) {
+    enum intr_level old_level;
+
     ASSERT(t != NULL);
     ASSERT(PRI_MIN <= priority && priority <= PRI_MAX);
     ASSERT(name != NULL);
@@ -621,8 +1196,9 @@ static void init_thread(struct thread *t, const char *name, int priority) {
     t->tf.rsp = (uint64_t)t + PGSIZE - sizeof(void *);
     t->priority = priority;
     t->init_priority = priority;
+    t->tickets = t->init_tickets = TICKETS_DEFAULT;
     t->wait_on_lock = NULL;
-    list_init (&t->donations);
+    list_init (&t->held_locks);
 
     // project 2: system call
     list_init (&t->child_list);
@@ -631,6 +1207,10 @@ static void init_thread(struct thread *t, const char *name, int priority) {
     sema_init (&t->fork_sema, 0);
 
     t->magic = THREAD_MAGIC;
+
+    old_level = intr_disable();
+    list_push_back(&all_list, &t->all_elem);
+    intr_set_level(old_level);
 }
 
 /* 실행할 다음 스레드를 선택하고 반환합니다. 실행 큐에서 스레드를 반환해야 합니다.
@@ -642,10 +1222,143 @@ static void init_thread(struct thread *t, const char *name, int priority) {
    will be in the run queue.)  If the run queue is empty, return
    idle_thread. */
 static struct thread *next_thread_to_run(void) {
-    if (list_empty(&ready_list))
+    if (ready_count == 0)
         return idle_thread;
     else
-        return list_entry(list_pop_front(&ready_list), struct thread, elem);
+        return ready_queue_pop();
+}
+
+/* T를 자신의 우선순위에 해당하는 준비 큐의 맨 뒤에 넣습니다.
+   같은 우선순위 안에서는 라운드-로빈 순서가 유지됩니다. */
+/* Appends T to the ready queue for its priority, keeping
+   round-robin order among threads of equal priority.  EDF
+   threads with budget left go into edf_ready instead, and under
+   CFS or the stride scheduler threads go into the vruntime or
+   pass tree.  Interrupts must be off. */
+static void ready_queue_push(struct thread *t) {
+    ASSERT(intr_get_level() == INTR_OFF);
+    ASSERT(PRI_MIN <= t->priority && t->priority <= PRI_MAX);
+
+    ready_count++;
+    if (edf_active(t)) {
+        rb_insert(&edf_ready, &t->tree_elem);
+        return;
+    }
+    if (thread_cfs) {
+        rb_insert(&cfs_tree, &t->tree_elem);
+        return;
+    }
+    if (thread_stride) {
+        rb_insert(&stride_tree, &t->tree_elem);
+        return;
+    }
+    list_push_back(&ready_queues[t->priority], &t->elem);
+    ready_mask |= 1ULL << t->priority;
+}
+
+/* 준비 큐에 있는 T를 제거합니다. T의 우선순위는 삽입된 이후 바뀌지 않았어야 합니다. */
+/* Removes ready thread T from its ready queue.  T's priority
+   must not have changed since it was queued. */
+static void ready_queue_remove(struct thread *t) {
+    ASSERT(intr_get_level() == INTR_OFF);
+    ASSERT(t->status == THREAD_READY);
+
+    ready_count--;
+    if (edf_active(t)) {
+        rb_remove(&edf_ready, &t->tree_elem);
+        return;
+    }
+    if (thread_cfs) {
+        rb_remove(&cfs_tree, &t->tree_elem);
+        return;
+    }
+    if (thread_stride) {
+        rb_remove(&stride_tree, &t->tree_elem);
+        return;
+    }
+    list_remove(&t->elem);
+    if (list_empty(&ready_queues[t->priority]))
+        ready_mask &= ~(1ULL << t->priority);
+}
+
+/* 가장 높은 우선순위 큐의 맨 앞 스레드를 꺼냅니다. */
+/* Pops the EDF thread with the earliest deadline if there is
+   one, otherwise the thread at the front of the highest non-empty
+   ready queue, or under CFS or the stride scheduler the leftmost
+   thread of the ready tree.  The ready queues must not be
+   empty. */
+static struct thread *ready_queue_pop(void) {
+    int priority;
+    struct thread *t;
+
+    ASSERT(ready_count > 0);
+    ready_count--;
+
+    if (!rb_empty(&edf_ready)) {
+        t = rb_entry(rb_min(&edf_ready), struct thread, tree_elem);
+        rb_remove(&edf_ready, &t->tree_elem);
+        return t;
+    }
+    if (thread_cfs) {
+        t = rb_entry(rb_min(&cfs_tree), struct thread, tree_elem);
+        rb_remove(&cfs_tree, &t->tree_elem);
+        cfs_update_min_vruntime();
+        return t;
+    }
+    if (thread_stride) {
+        t = rb_entry(rb_min(&stride_tree), struct thread, tree_elem);
+        rb_remove(&stride_tree, &t->tree_elem);
+        stride_update_global_pass();
+        return t;
+    }
+
+    priority = ready_queue_max_priority();
+    t = list_entry(list_pop_front(&ready_queues[priority]), struct thread, elem);
+    if (list_empty(&ready_queues[priority]))
+        ready_mask &= ~(1ULL << priority);
+    return t;
+}
+
+/* 준비 상태인 스레드 중 가장 높은 우선순위를 반환하고, 없으면 -1을 반환합니다. */
+/* Returns the highest priority among ready threads, or -1 if
+   no thread is ready. */
+static int ready_queue_max_priority(void) {
+    if (ready_mask == 0)
+        return -1;
+    return 63 - __builtin_clzll(ready_mask);
+}
+
+/* 준비 상태인 스레드가 CURR 대신 실행되어야 하면 true를 반환합니다.
+   우선순위 스케줄러에서는 더 높은 우선순위가, CFS에서는 한 틱 이상 작은
+   vruntime이, 보폭 스케줄러에서는 더 작은 pass가 기준입니다.
+   인터럽트가 꺼져 있어야 합니다. */
+/* Returns true if some ready thread should run instead of CURR:
+   an EDF thread with an earlier deadline, one of higher
+   priority, under CFS one that is more than a tick behind CURR
+   in vruntime, or under the stride scheduler one with a smaller
+   pass.  Interrupts must be off. */
+static bool ready_queue_preempts(struct thread *curr) {
+    ASSERT(intr_get_level() == INTR_OFF);
+
+    if (ready_count == 0)
+        return false;
+    if (curr == idle_thread)
+        return true;
+    if (!rb_empty(&edf_ready)) {
+        struct thread *t = rb_entry(rb_min(&edf_ready), struct thread, tree_elem);
+        return !edf_active(curr) || t->edf_abs_deadline < curr->edf_abs_deadline;
+    }
+    if (edf_active(curr))
+        return false;
+    if (thread_cfs) {
+        struct thread *min = rb_entry(rb_min(&cfs_tree), struct thread, tree_elem);
+        return min->vruntime + CFS_TICK < curr->vruntime;
+    }
+    if (thread_stride) {
+        struct thread *min = rb_entry(rb_min(&stride_tree), struct thread, tree_elem);
+        return min->pass < curr->pass;
+    }
+    return ready_queue_max_priority() > curr->priority;
 }
 
 /* iretq를 사용하여 스레드를 시작합니다. */
@@ -693,68 +1406,26 @@ void do_iret(struct intr_frame *tf) {
    complete.  In practice that means that printf()s should be
    added at the end of the function. */
 static void thread_launch(struct thread *th) {
-    uint64_t tf_cur = (uint64_t)&running_thread()->tf;  // 현재 실행 중인 스레드의 프레임 주소를 가져옵니다.
-    uint64_t tf = (uint64_t)&th->tf;                    // 전환될 새 스레드의 프레임 주소를 가져옵니다.
-    ASSERT(intr_get_level() == INTR_OFF);               // 인터럽트가 비활성화되었는지 확인합니다.
-
-    /* 주 스위칭 로직입니다.
-     * 먼저 전체 실행 컨텍스트를 intr_frame으로 복원하고 do_iret를 호출하여 다음 스레드로 전환합니다.
-     * 여기서 스위칭이 완료될 때까지 스택을 사용해서는 안 됩니다. */
-    /* The main switching logic.
-     * We first restore the whole execution context into the intr_frame
-     * and then switching to the next thread by calling do_iret.
-     * Note that, we SHOULD NOT use any stack from here
-     * until switching is done. */
-    __asm __volatile(
-        /* 사용될 레지스터를 저장합니다. */ 
-        /* Store registers that will be used. */
-        // 레지스터에 저장된 값을 스택에 밀어넣기
-        "push %%rax\n"
-        "push %%rbx\n"
-        "push %%rcx\n"
-        /* 입력을 한 번만 가져옵니다. */
-        /* Fetch input once */
-        "movq %0, %%rax\n"
-        "movq %1, %%rcx\n"
-        "movq %%r15, 0(%%rax)\n"
-        "movq %%r14, 8(%%rax)\n"
-        "movq %%r13, 16(%%rax)\n"
-        "movq %%r12, 24(%%rax)\n"
-        "movq %%r11, 32(%%rax)\n"
-        "movq %%r10, 40(%%rax)\n"
-        "movq %%r9, 48(%%rax)\n"
-        "movq %%r8, 56(%%rax)\n"
-        "movq %%rsi, 64(%%rax)\n"
-        "movq %%rdi, 72(%%rax)\n"
-        "movq %%rbp, 80(%%rax)\n"
-        "movq %%rdx, 88(%%rax)\n"
-        "pop %%rbx\n"  // Saved rcx
-        "movq %%rbx, 96(%%rax)\n"
-        "pop %%rbx\n"  // Saved rbx
-        "movq %%rbx, 104(%%rax)\n"
-        "pop %%rbx\n"  // Saved rax
-        "movq %%rbx, 112(%%rax)\n"
-        "addq $120, %%rax\n"
-        "movw %%es, (%%rax)\n"
-        "movw %%ds, 8(%%rax)\n"
-        "addq $32, %%rax\n"
-        "call __next\n"  // read the current rip.
-        "__next:\n"
-        "pop %%rbx\n"
-        "addq $(out_iret -  __next), %%rbx\n"
-        "movq %%rbx, 0(%%rax)\n"  // rip
-        "movw %%cs, 8(%%rax)\n"   // cs
-        "pushfq\n"
-        "popq %%rbx\n"
-        "mov %%rbx, 16(%%rax)\n"  // eflags
-        "mov %%rsp, 24(%%rax)\n"  // rsp
-        "movw %%ss, 32(%%rax)\n"
-        "mov %%rcx, %%rdi\n"
-        "call do_iret\n"
-        "out_iret:\n"
-        :
-        : "g"(tf_cur), "g"(tf)
-        : "memory");
+    struct thread *curr = running_thread();
+
+    ASSERT(intr_get_level() == INTR_OFF);
+
+    /* 자발적인 전환이므로 호출 규약상 보존해야 하는 레지스터와 rsp만 저장하면 됩니다.
+       처음 실행되는 스레드는 thread_entry()를 거쳐 iretq로 진입합니다. */
+    /* The switch is a function call, so only the callee-saved
+       registers and rsp need saving.  A thread that has never
+       run enters through thread_entry() and the iretq path. */
+    thread_switch(&curr->switch_rsp, th->switch_rsp);
+}
+
+/* 새 스레드가 처음 스케줄될 때 thread_switch()가 "반환"하는 곳입니다. */
+/* Where thread_switch() "returns" the first time a new thread is
+   scheduled.  Enters the thread through the full iretq path,
+   loading the initial register state that thread_create() left
+   in its intr_frame. */
+static void thread_entry(void) {
+    do_iret(&running_thread()->tf);
+    NOT_REACHED();
 }
 
 /* 새 프로세스를 스케줄링합니다. 진입 시, 인터럽트는 꺼져 있어야 합니다.
@@ -770,7 +1441,8 @@ static void do_schedule(int status) {
     ASSERT(thread_current()->status == THREAD_RUNNING);
     while (!list_empty(&destruction_req)) {
         struct thread *victim = list_entry(list_pop_front(&destruction_req), struct thread, elem);
-        palloc_free_page(victim);
+        if (!page_cache_put(&thread_page_cache, victim))
+            palloc_free_page(victim);
     }
     thread_current()->status = status;
     schedule();
@@ -782,11 +1454,21 @@ static void do_schedule(int status) {
    또한, 다음에 실행될 스레드가 유효한 스레드 객체인지 확인합니다. */
 static void schedule(void) {
     struct thread *curr = running_thread();      // 현재 실행 중인 스레드를 가져옵니다.
-    struct thread *next = next_thread_to_run();  // 다음에 실행할 스레드를 결정합니다.
+    struct thread *next;
 
     ASSERT(intr_get_level() == INTR_OFF);    // 인터럽트가 비활성화되었는지 확인합니다.
     ASSERT(curr->status != THREAD_RUNNING);  // 현재 스레드의 상태가 실행 중이 아닌지 확인합니다.
-    ASSERT(is_thread(next));                 // 다음 스레드가 유효한 스레드인지 확인합니다.
+
+    /* 유휴 상태를 벗어나면 건너뛴 틱을 따라잡습니다. 따라잡은 틱이 MLFQS
+       우선순위를 다시 계산할 수 있으므로 다음 스레드를 고르기 전에 합니다. */
+    /* Leaving idle: catch up on ticks the one-shot skipped.  This
+       comes before choosing the next thread, because the replayed
+       ticks may recompute MLFQS priorities. */
+    if (curr == idle_thread)
+        timer_idle_exit();
+
+    next = next_thread_to_run();  // 다음에 실행할 스레드를 결정합니다.
+    ASSERT(is_thread(next));      // 다음 스레드가 유효한 스레드인지 확인합니다.
 
     /* 다음 스레드의 상태를 '실행 중'으로 설정합니다. */
     /* Mark us as running. */
@@ -818,6 +1500,8 @@ static void schedule(void) {
             list_push_back(&destruction_req, &curr->elem);
         }
 
+        TRACE(TRACE_SWITCH, curr->tid, next->tid);
+
         /* 전환할 스레드를 선택한 후, 우리는 먼저 현재 실행 중인 스레드의 정보를 저장합니다. */
         /* Before switching the thread, we first save the information
          * of current running. */
@@ -825,6 +1509,58 @@ static void schedule(void) {
     }
 }
 
+/* 파일 디스크립터 테이블 FDT를 해제합니다. 모든 파일이 닫혀 있어야 합니다. */
+/* Frees file descriptor table FDT, keeping its page for the
+   next thread_create().  Every file in FDT must already be
+   closed. */
+void thread_free_fdt(struct file **fdt) {
+    if (!page_cache_put(&fdt_page_cache, fdt))
+        palloc_free_page(fdt);
+}
+
+/* 빈 페이지 캐시 PC를 초기화합니다. */
+/* Initializes PC as an empty page cache. */
+static void page_cache_init(struct page_cache *pc) {
+    pc->top = NULL;
+    pc->cnt = 0;
+}
+
+/* PC에서 페이지 하나를 꺼내고, 비어 있으면 널 포인터를 반환합니다. */
+/* Pops a page from PC, or returns a null pointer if PC is
+   empty.  The page's first word holds garbage. */
+static void *page_cache_get(struct page_cache *pc) {
+    enum intr_level old_level;
+    void *page;
+
+    old_level = intr_disable();
+    page = pc->top;
+    if (page != NULL) {
+        pc->top = *(void **)page;
+        pc->cnt--;
+    }
+    intr_set_level(old_level);
+    return page;
+}
+
+/* PAGE를 PC에 넣습니다. PC가 가득 차 있으면 false를 반환하며, 이때 호출자가
+   페이지를 해제해야 합니다. */
+/* Pushes PAGE onto PC.  Returns false if PC is already full, in
+   which case the caller must free PAGE itself. */
+static bool page_cache_put(struct page_cache *pc, void *page) {
+    enum intr_level old_level;
+    bool ok = false;
+
+    old_level = intr_disable();
+    if (pc->cnt < PAGE_CACHE_MAX) {
+        *(void **)page = pc->top;
+        pc->top = page;
+        pc->cnt++;
+        ok = true;
+    }
+    intr_set_level(old_level);
+    return ok;
+}
+
 /* 새 스레드를 위한 tid를 반환합니다. */
 /* Returns a tid to use for a new thread. */
 static tid_t allocate_tid(void) {
@@ -838,43 +1574,114 @@ static tid_t allocate_tid(void) {
     return tid;
 }
 
-bool thread_compare_donate_priority(struct list_elem *e1, struct list_elem *e2, void *aux) {
-	return list_entry(e1,struct thread,donation_elem)->priority > list_entry(e2,struct thread, donation_elem)->priority;
+/* LOCK을 기다리는 스레드 중 가장 높은 우선순위를 반환합니다. 대기자는 우선순위 힙에
+   있으므로 O(1)입니다. LOCK에는 대기자가 있어야 합니다. */
+/* Returns the highest priority among LOCK's waiters, which must
+   not be empty.  They are kept in a heap by priority, so this is
+   O(1). */
+static int lock_donated_priority(struct lock *lock) {
+    return pheap_entry(pheap_top(&lock->waiters), struct thread, wait_elem)->priority;
 }
 
-void donate_priority(void) {
+/* T의 우선순위를 기본 우선순위와, T가 가진 (대기자가 있는) 락마다 가장 높은 대기자
+   우선순위 중 최댓값으로 다시 계산합니다. 바뀌었으면 true를 반환합니다. */
+/* Recomputes T's priority as the maximum of its base priority and
+   the top waiter of each lock it holds that has waiters, which
+   costs one step per such lock rather than one per waiting
+   thread.  Returns true if T's priority changed.  Interrupts must
+   be off. */
+static bool thread_update_priority(struct thread *t) {
+    struct list_elem *e;
+    int priority = t->init_priority;
 
-    int depth;
-    struct thread *curr = thread_current();
+    for (e = list_begin(&t->held_locks); e != list_end(&t->held_locks); e = list_next(e)) {
+        int donated = lock_donated_priority(list_entry(e, struct lock, held_elem));
+        if (donated > priority)
+            priority = donated;
+    }
+    if (priority == t->priority)
+        return false;
+
+    if (t->status == THREAD_READY) {
+        /* 준비 큐는 우선순위별로 나뉘어 있으므로 다시 넣어야 합니다. */
+        /* Ready queues are indexed by priority, so requeue. */
+        ready_queue_remove(t);
+        t->priority = priority;
+        ready_queue_push(t);
+    } else
+        t->priority = priority;
+    /* 락을 기다리는 중이라면 그 대기 큐에서의 위치도 바로잡습니다. */
+    /* If T is itself waiting, reposition it in its wait queue as
+       well, which updates that lock's top waiter. */
+    synch_priority_changed(t);
+    return true;
+}
 
-    for (depth = 0; depth < 8 ; depth++) {
-        if(!curr->wait_on_lock || curr->wait_on_lock->holder == NULL) 
-            break;
-        struct thread *holder = curr->wait_on_lock->holder;
-        holder->priority = curr->priority;
-        curr = holder;
+/* T가 기다리는 락과 그 보유자에게 DELTA만큼의 티켓을 더하고, wait_on_lock 사슬을
+   따라 계속 올라갑니다. 티켓은 합이므로 중간에 멈추면 합계가 어긋나게 됩니다. */
+/* Adds DELTA tickets to the lock T waits on and to its holder,
+   and so on up the chain of wait_on_lock.  Ticket totals are
+   sums, so stopping partway would leave them inconsistent: the
+   walk only ends with the chain. */
+static void stride_donate(struct thread *t, int delta) {
+    while (delta != 0 && t->wait_on_lock != NULL) {
+        struct lock *lock = t->wait_on_lock;
+        struct thread *holder = lock_owner(lock);
+
+        lock->donated_tickets += delta;
+        holder->tickets += delta;
+        t = holder;
     }
 }
 
-void remove_with_lock(struct lock *lock) {
-    struct list_elem *e;
-    struct thread *curr = thread_current();
+/* 실행 중인 스레드가 wait_on_lock의 대기 큐에 들어간 직후에 호출되어, 락 보유자
+   사슬을 따라 우선순위를 기부합니다. 보유자의 우선순위가 더 이상 바뀌지 않거나
+   DONATE_DEPTH_MAX 단계에 이르면 멈춥니다. 보폭 스케줄러에서는 티켓을 기부합니다.
+   인터럽트가 꺼져 있어야 합니다. */
+/* Called with interrupts off just after the running thread has
+   joined the wait queue of its wait_on_lock.  Donates priority up
+   the chain of lock holders, stopping as soon as a holder's
+   priority does not change or after DONATE_DEPTH_MAX locks.  The
+   stride scheduler donates tickets instead. */
+void donate_priority(void) {
+    struct thread *t = thread_current();
+    int depth;
+
+    ASSERT(intr_get_level() == INTR_OFF);
+    ASSERT(t->wait_on_lock != NULL);
 
-    for (e = list_begin(&curr->donations); e != list_end(&curr->donations); e = list_next(e)) {
-        struct thread *t = list_entry(e, struct thread, donation_elem);
-        if (t->wait_on_lock == lock) 
-            list_remove(&t->donation_elem);
+    if (thread_stride) {
+        stride_donate(t, t->tickets);
+        return;
+    }
+    for (depth = 0; depth < DONATE_DEPTH_MAX && t->wait_on_lock != NULL; depth++) {
+        struct thread *holder = lock_owner(t->wait_on_lock);
+
+        if (holder == NULL || !thread_update_priority(holder))
+            break;
+        t = holder;
     }
 }
 
-void refresh_priority(void) {
+/* 실행 중인 스레드가 대기자가 있는 LOCK을 NEXT에게 넘길 때 호출됩니다. LOCK을 통해
+   받은 기부를 되돌리고, NEXT가 남은 대기자들로부터 기부를 받게 합니다. LOCK은 이미
+   held_locks 목록 사이를 옮겨진 상태여야 하며, 인터럽트가 꺼져 있어야 합니다. */
+/* Called with interrupts off when the running thread hands LOCK,
+   which had waiters, over to NEXT.  Undoes what was donated to
+   us through LOCK and lets NEXT inherit donations from the
+   waiters that remain.  LOCK must already have been moved from
+   our held_locks to NEXT's, if it still has waiters. */
+void donate_handoff(struct lock *lock, struct thread *next) {
     struct thread *curr = thread_current();
-    curr->priority = curr->init_priority;
-    
-    if (!list_empty(&curr->donations)) {
-        list_sort(&curr->donations, thread_compare_donate_priority, NULL);
-        struct thread *front = list_entry(list_front(&curr->donations), struct thread, donation_elem);
-        if (front->priority > curr->priority)
-            curr->priority = front->priority;
+
+    ASSERT(intr_get_level() == INTR_OFF);
+
+    if (thread_stride) {
+        curr->tickets -= lock->donated_tickets;
+        lock->donated_tickets -= next->tickets;
+        next->tickets += lock->donated_tickets;
+        return;
     }
-}
\ No newline at end of file
+    thread_update_priority(curr);
+    thread_update_priority(next);
+}
@@ -0,0 +1,119 @@
+#include "threads/trace.h"
+
+#include <debug.h>
+#include <intrinsic.h>
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "devices/timer.h"
+#include "threads/palloc.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+
+/* 링 버퍼 크기. 2의 거듭제곱이어야 합니다. */
+/* Records in the ring buffer.  Must be a power of 2. */
+#define TRACE_CAP 4096
+#define TRACE_PAGES (TRACE_CAP * sizeof(struct trace_record) / PGSIZE)
+
+/* "-trace"가 주어졌는지 여부. */
+/* Set by the "-trace" command-line option. */
+bool trace_requested;
+
+/* true이면 추적점이 레코드를 남깁니다. */
+/* True if tracepoints record events. */
+bool trace_enabled;
+
+/* 링 버퍼와, 지금까지 예약된 레코드 수. */
+/* Ring buffer, and the number of records ever reserved in it. */
+static struct trace_record *trace_buf;
+static uint64_t trace_head;
+
+static const char *event_names[TRACE_EVENT_CNT] = {
+    [TRACE_SWITCH] = "switch",
+    [TRACE_PAGE_FAULT] = "page_fault",
+    [TRACE_SYSCALL] = "syscall",
+    [TRACE_DISK_READ] = "disk_read",
+    [TRACE_DISK_WRITE] = "disk_write",
+    [TRACE_PALLOC] = "palloc",
+};
+
+/* "-trace"가 주어졌으면 링 버퍼를 할당하고 추적을 켭니다. palloc_init()
+   이후에 호출해야 합니다. 그 전의 추적점은 아무것도 남기지 않습니다. */
+/* If "-trace" was given, allocates the ring buffer and turns
+   tracing on.  Must be called after palloc_init(); tracepoints
+   hit before then record nothing. */
+void trace_init(void) {
+    ASSERT(sizeof(struct trace_record) * TRACE_CAP % PGSIZE == 0);
+
+    if (!trace_requested)
+        return;
+
+    trace_buf = palloc_get_multiple(PAL_ZERO, TRACE_PAGES);
+    if (trace_buf == NULL) {
+        printf("trace: no memory for ring buffer, tracing disabled\n");
+        return;
+    }
+    trace_enabled = true;
+}
+
+/* EVENT를 인자 ARG0, ARG1과 함께 기록합니다. 원자적 증가로 슬롯을 예약하므로
+   락이 필요 없고, 인터럽트 핸들러를 포함해 어디서나 호출할 수 있습니다.
+   보통은 TRACE 매크로를 통해 호출합니다. */
+/* Records EVENT with arguments ARG0 and ARG1.  A slot is reserved
+   with an atomic increment, so no lock is taken and this may be
+   called from anywhere, interrupt handlers included.  The slot's
+   sequence number is stored last, which lets trace_dump() skip a
+   record whose writer was interrupted partway.  Normally called
+   through the TRACE macro. */
+void trace_log(enum trace_event event, uint64_t arg0, uint64_t arg1) {
+    uint64_t idx = __atomic_fetch_add(&trace_head, 1, __ATOMIC_RELAXED);
+    struct trace_record *r = &trace_buf[idx & (TRACE_CAP - 1)];
+    struct thread *t = pg_round_down(rrsp());
+
+    r->seq = 0;
+    r->ns = timer_ns();
+    r->arg0 = arg0;
+    r->arg1 = arg1;
+    r->tid = t->tid;
+    r->event = event;
+    __atomic_store_n(&r->seq, (uint32_t)(idx + 1), __ATOMIC_RELEASE);
+}
+
+/* 링 버퍼에 남은 레코드를 오래된 것부터 한 줄에 하나씩 출력합니다. 출력하는
+   동안에는 추적을 멈춥니다. 각 줄은 "T 나노초 TID 이벤트 인자0 인자1"
+   형식이며 시각은 10진수, 인자는 16진수입니다. */
+/* Prints the records left in the ring buffer, oldest first, one
+   per line as "T ns tid event arg0 arg1", with the time in
+   decimal nanoseconds since boot and the arguments in hex.
+   Tracing is suspended meanwhile, so that printing does not
+   overwrite what it prints. */
+void trace_dump(void) {
+    uint64_t head, idx, first;
+    uint64_t skipped = 0;
+
+    if (trace_buf == NULL) {
+        printf("trace: tracing is not enabled (use -trace)\n");
+        return;
+    }
+
+    trace_enabled = false;
+    head = __atomic_load_n(&trace_head, __ATOMIC_ACQUIRE);
+    first = head > TRACE_CAP ? head - TRACE_CAP : 0;
+
+    printf("trace: %llu events, %llu overwritten\n", (unsigned long long)head,
+           (unsigned long long)first);
+    for (idx = first; idx < head; idx++) {
+        const struct trace_record *r = &trace_buf[idx & (TRACE_CAP - 1)];
+
+        if (__atomic_load_n(&r->seq, __ATOMIC_ACQUIRE) != (uint32_t)(idx + 1) ||
+            r->event >= TRACE_EVENT_CNT) {
+            skipped++;
+            continue;
+        }
+        printf("T %" PRId64 " %d %s %llx %llx\n", r->ns, r->tid,
+               event_names[r->event], (unsigned long long)r->arg0, (unsigned long long)r->arg1);
+    }
+    if (skipped > 0)
+        printf("trace: %llu incomplete records skipped\n", (unsigned long long)skipped);
+    trace_enabled = true;
+}
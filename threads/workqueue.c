@@ -0,0 +1,110 @@
+#include "threads/workqueue.h"
+
+#include <debug.h>
+#include <stdio.h>
+
+#include "threads/interrupt.h"
+#include "threads/thread.h"
+
+/* 특정 큐를 지정하지 않은 작업이 들어가는 시스템 작업 큐. */
+/* System work queue, used by work_schedule(). */
+static struct workqueue system_wq;
+
+static void worker(void *wq_);
+
+/* 시스템 작업 큐와 그 워커를 만듭니다. thread_start() 이후에 호출해야 합니다.
+   워커는 PRI_MAX로 실행되므로, 인터럽트 핸들러가 넘긴 일은 핸들러가 반환한
+   직후에 처리됩니다. */
+/* Creates the system work queue and its worker.  Must be called
+   after thread_start().  The worker runs at PRI_MAX, so work
+   scheduled by an interrupt handler runs as soon as the handler
+   returns, only now with interrupts on. */
+void workqueue_init(void) {
+    workqueue_create(&system_wq, "kworker", PRI_MAX, 1);
+}
+
+/* 이름이 NAME이고 우선순위 PRIORITY의 워커 WORKER_CNT개를 가진 작업 큐 WQ를
+   초기화합니다. */
+/* Initializes work queue WQ, named NAME, and starts WORKER_CNT
+   worker threads for it at PRIORITY. */
+void workqueue_create(struct workqueue *wq, const char *name, int priority, int worker_cnt) {
+    int i;
+
+    ASSERT(wq != NULL);
+    ASSERT(worker_cnt > 0);
+
+    wq->name = name;
+    list_init(&wq->works);
+    sema_init(&wq->work_cnt, 0);
+
+    for (i = 0; i < worker_cnt; i++)
+        if (thread_create(name, priority, worker, wq) == TID_ERROR)
+            PANIC("%s: can't create worker", name);
+}
+
+/* WORK가 AUX를 인자로 FUNC를 실행하도록 초기화합니다. */
+/* Initializes WORK to run FUNC, passing AUX. */
+void work_init(struct work *work, work_func *func, void *aux) {
+    ASSERT(work != NULL);
+    ASSERT(func != NULL);
+
+    work->func = func;
+    work->aux = aux;
+    work->pending = false;
+}
+
+/* WORK를 시스템 작업 큐에 넣습니다. workqueue_schedule()을 참고하세요. */
+/* Schedules WORK on the system work queue.  See
+   workqueue_schedule(). */
+bool work_schedule(struct work *work) {
+    return workqueue_schedule(&system_wq, work);
+}
+
+/* WORK를 작업 큐 WQ에 넣습니다. WORK가 이미 기다리는 중이면 아무것도 하지 않고
+   false를 반환합니다. 잠들지 않으므로 인터럽트 핸들러에서 호출할 수 있습니다.
+   WORK는 실행이 시작될 때까지 유효해야 하며, 실행 중에 다시 넣을 수 있습니다. */
+/* Queues WORK on WQ and returns true, or returns false without
+   doing anything if WORK is already waiting to run, so that any
+   number of schedules before it starts coalesce into one run.
+   Does not sleep, so it may be called from an interrupt handler.
+   WORK must stay valid until it starts running; it may be
+   scheduled again from its own function. */
+bool workqueue_schedule(struct workqueue *wq, struct work *work) {
+    enum intr_level old_level;
+
+    ASSERT(wq != NULL);
+    ASSERT(work != NULL);
+
+    old_level = intr_disable();
+    if (work->pending) {
+        intr_set_level(old_level);
+        return false;
+    }
+    work->pending = true;
+    list_push_back(&wq->works, &work->elem);
+    intr_set_level(old_level);
+
+    sema_up(&wq->work_cnt);
+    return true;
+}
+
+/* 작업 큐 WQ_의 워커 스레드. 작업을 하나씩 꺼내어 인터럽트가 켜진 상태로
+   실행합니다. */
+/* Worker thread for work queue WQ_.  Takes work off the queue one
+   piece at a time and runs it with interrupts on. */
+static void worker(void *wq_) {
+    struct workqueue *wq = wq_;
+
+    for (;;) {
+        enum intr_level old_level;
+        struct work *work;
+
+        sema_down(&wq->work_cnt);
+        old_level = intr_disable();
+        work = list_entry(list_pop_front(&wq->works), struct work, elem);
+        work->pending = false;
+        intr_set_level(old_level);
+
+        work->func(work->aux);
+    }
+}
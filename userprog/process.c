@@ -433,7 +433,7 @@ void process_exit(void) {
     // 실행중에 수정 못하도록
     file_close(curr->running);
     // 메모리 누수 방지
-    palloc_free_page(curr->fdt);
+    thread_free_fdt(curr->fdt);
     // 추후 프로세스 종료 메시지 구현할 것
     process_cleanup();
     
@@ -570,16 +570,13 @@ static bool load(const char *file_name, struct intr_frame *if_) {
     process_activate(thread_current()); // 페이지 테이블 활성화
 
     /* (프로그램 파일) 실행 파일을 엽니다. */
-    lock_acquire(&filesys_lock);
     file = filesys_open(file_name);
     if (file == NULL) {
-        lock_release(&filesys_lock);
         printf("load: %s: open failed\n", file_name);
         goto done;
     }
     t -> running = file;
     file_deny_write(t->running);
-    lock_release(&filesys_lock);
 
     /* 실행 가능한 헤더를 읽고 확인합니다. */
     if (file_read(file, &ehdr, sizeof ehdr) != sizeof ehdr || memcmp(ehdr.e_ident, "\177ELF\2\1\1", 7) || ehdr.e_type != 2 || ehdr.e_machine != 0x3E  // amd64
@@ -891,7 +888,7 @@ static bool load_segment(struct file *file, off_t ofs, uint8_t *upage, uint32_t
 
         /* TODO: Set up aux to pass information to the lazy_load_segment. */
 		/* container 생성 */
-		struct container *container = (struct container *)malloc(sizeof(struct container));
+		struct container *container = slab_alloc(&container_slab);
 		container->file = file;
 		container->page_read_bytes = page_read_bytes;
 		container->offset = ofs;
@@ -1,5 +1,6 @@
 #include "userprog/syscall.h"
 
+#include <hash.h>
 #include <stdio.h>
 #include <syscall-nr.h>
 #include <user/syscall.h>
@@ -10,10 +11,14 @@
 #include "threads/flags.h"
 #include "threads/interrupt.h"
 #include "threads/loader.h"
+#include "threads/mmu.h"
+#include "threads/synch.h"
 #include "threads/thread.h"
+#include "threads/trace.h"
 #include "userprog/gdt.h"
 #include "userprog/process.h"
 #include <threads/palloc.h>
+#include "devices/timer.h"
 
 
 void syscall_entry(void);
@@ -36,6 +41,39 @@ unsigned tell(int fd);
 void close (int fd);
 int wait (pid_t pid);
 int exec(const char *cmd_line);
+int futex_wait(int *addr, int val);
+int futex_wake(int *addr, int n);
+static void futex_init(void);
+
+/* 퓨텍스(futex) 대기 큐의 해시 테이블 버킷 수. 2의 거듭제곱이어야 합니다. */
+/* Buckets in the futex wait-queue hash.  Must be a power of 2. */
+#define FUTEX_BUCKETS 64
+
+/* 퓨텍스 버킷. 키가 이 버킷으로 해시되는 대기자들을 담습니다. */
+/* A futex hash bucket: the waiters whose keys hash to it. */
+struct futex_bucket {
+    struct lock lock;     /* WAITERS를 보호합니다. */ /* Protects WAITERS. */
+    struct list waiters;  /* struct futex_waiter의 리스트. */ /* List of struct futex_waiter. */
+};
+
+/* 퓨텍스 워드를 식별하는 키. 워드가 어느 주소에 매핑되어 있는지, 지금 어느
+   프레임에 있는지와 무관합니다. */
+/* Identifies a futex word independently of the address it is
+   mapped at and of the frame that currently holds it. */
+struct futex_key {
+    const void *object;      /* 파일의 아이노드, 또는 비공유 페이지. */ /* Backing inode, or the private page. */
+    uint64_t offset;         /* OBJECT 안에서 워드의 바이트 오프셋. */ /* Byte offset of the word in OBJECT. */
+};
+
+/* futex_wait()에서 잠든 스레드 하나. 그 스레드의 스택에 있습니다. */
+/* A thread sleeping in futex_wait(), on that thread's stack. */
+struct futex_waiter {
+    struct list_elem elem;   /* futex_bucket의 waiters 요소. */ /* In a bucket's WAITERS. */
+    struct futex_key key;    /* 기다리는 퓨텍스 워드. */ /* Futex word waited on. */
+    struct semaphore wakeup; /* futex_wake()가 올립니다. */ /* Upped by futex_wake(). */
+};
+
+static struct futex_bucket futex_table[FUTEX_BUCKETS];
 
 /* 시스템 호출.
  *
@@ -77,7 +115,8 @@ syscall_init (void) {
 	write_msr(MSR_SYSCALL_MASK,
 			FLAG_IF | FLAG_TF | FLAG_DF | FLAG_IOPL | FLAG_AC | FLAG_NT);
 
-    lock_init(&filesys_lock);
+	futex_init();
+
 }
 
 /* 주요 시스템 호출 인터페이스 */
@@ -86,6 +125,8 @@ void syscall_handler(struct intr_frame *f UNUSED) {
 
     int sys_num = f->R.rax;
 
+    TRACE(TRACE_SYSCALL, sys_num, f->R.rdi);
+
     switch (sys_num) {
         case SYS_HALT:
             halt();
@@ -135,6 +176,15 @@ void syscall_handler(struct intr_frame *f UNUSED) {
         case SYS_MUNMAP:
             munmap(f->R.rdi);
             break;
+        case SYS_CLOCK:
+            f->R.rax = timer_ns();
+            break;
+        case SYS_FUTEX_WAIT:
+            f->R.rax = futex_wait((int *)f->R.rdi, f->R.rsi);
+            break;
+        case SYS_FUTEX_WAKE:
+            f->R.rax = futex_wake((int *)f->R.rdi, f->R.rsi);
+            break;
         default:
             thread_exit();
             break;
@@ -206,9 +256,7 @@ void exit(int status) {
 bool create(const char *name, unsigned initial_size) {
     check_address(name);
 
-    lock_acquire(&filesys_lock);
     bool success = filesys_create(name, initial_size);
-    lock_release(&filesys_lock);
 
     return success;
 }
@@ -216,9 +264,7 @@ bool create(const char *name, unsigned initial_size) {
 bool remove(const char *name) {
     check_address(name);
 
-    lock_acquire(&filesys_lock);
     bool success = filesys_remove(name);
-    lock_release(&filesys_lock);
 
     return success;
 }
@@ -227,22 +273,17 @@ bool remove(const char *name) {
 int open(const char *file) {
     check_address(file);
 
-    lock_acquire(&filesys_lock);
     struct file *newfile = filesys_open(file);
 
     if (newfile == NULL)
-        goto err;
+        return -1;
 
     int fd = add_file_to_fdt(newfile);
 
     if (fd == -1)
         file_close(newfile);
 
-    lock_release(&filesys_lock);
     return fd;
-err:
-    lock_release(&filesys_lock);
-    return -1;
 }
 
 /* console 출력하는 함수 */
@@ -261,9 +302,7 @@ int write(int fd, const void *buffer, unsigned size) {
         result = size;
     }
     else { 
-        lock_acquire(&filesys_lock);
         result = file_write(file,buffer,size);
-        lock_release(&filesys_lock); 
     }
 
     return result;
@@ -330,15 +369,10 @@ int read(int fd, void *buffer, unsigned size) {
         exit(-1); // 유효하지 않은 파일 디스크립터
     }
 
-    // 구현 필요
-    // lock을 이용해서 커널이 파일을 읽는 동안 다른 스레드가 이 파일을 읽는 것을 막아야함
-
-    // filesys_lock 선언(syscall.h에 만들기)
-    // syscall_init에도 lock 초기화함수 lock_init을 선언  
-    lock_acquire(&filesys_lock);
-    // 그 외는 파일 객체 찾고, size 바이트 크기 만큼 파일을 읽어서 버퍼에 넣어준다.
+    // 동시 접근은 파일 시스템이 inode마다 읽기-쓰기 락으로 직렬화하므로
+    // 여기서 전역 락을 잡을 필요가 없다.
+    // 파일 객체 찾고, size 바이트 크기 만큼 파일을 읽어서 버퍼에 넣어준다.
     off_t read_count = file_read (file, buffer, size);
-    lock_release(&filesys_lock);
 
     return read_count;
 }
@@ -435,3 +469,117 @@ void *mmap(void *addr, size_t length, int writable, int fd, off_t offset) {
 void munmap(void *addr) {
     do_munmap(addr);
 }
+
+/* 퓨텍스 해시 테이블을 초기화합니다. */
+/* Initializes the futex hash table. */
+static void futex_init(void) {
+    for (int i = 0; i < FUTEX_BUCKETS; i++) {
+        lock_init(&futex_table[i].lock);
+        list_init(&futex_table[i].waiters);
+    }
+}
+
+/* 사용자 주소 ADDR에 있는 퓨텍스 워드의 키를 KEY에 저장합니다. 파일 매핑의 워드는
+   파일의 아이노드와 파일 안의 오프셋이 키이므로, 그 파일을 매핑한 모든 프로세스가 같은
+   퓨텍스를 씁니다. 그 밖의 워드는 이 프로세스만의 것이므로 struct page가 키입니다.
+   프레임과 달리 struct page는 페이지가 쫓겨났다가 다른 프레임으로 돌아와도 그대로이고,
+   fork 후 copy-on-write로 프레임을 공유하는 자식과도 겹치지 않습니다.
+   정렬되지 않은 주소면 false를 반환하고, 잘못된 주소면 프로세스를 종료합니다. */
+/* Stores in KEY the key of the futex word at user address ADDR.
+   A word in a file mapping is keyed by the file's inode and the
+   word's offset in the file, so every process mapping the file
+   shares the futex.  Any other word is private to this process
+   and is keyed by its struct page.  Unlike a frame, the page
+   stays the same when it is evicted and swapped back in to
+   another frame, and it is not shared with a fork child even
+   while their frames are shared copy-on-write.  Returns false if
+   ADDR is misaligned, and terminates the process if ADDR is not
+   a valid user address. */
+static bool futex_key(int *addr, struct futex_key *key) {
+    struct page *page;
+
+    if ((uintptr_t)addr % sizeof *addr != 0)
+        return false;
+
+    /* check_address()가 페이지를 불러오므로 초기화되지 않은 페이지는 남지 않습니다. */
+    /* check_address() faults the page in, so it is no longer
+       uninitialized. */
+    page = check_address(addr);
+    if (page == NULL)
+        return false;
+
+    if (VM_TYPE(page->operations->type) == VM_FILE) {
+        key->object = file_get_inode(page->file.file);
+        key->offset = page->file.offset + pg_ofs(addr);
+    } else {
+        key->object = page;
+        key->offset = pg_ofs(addr);
+    }
+    return true;
+}
+
+/* KEY가 해시되는 버킷을 반환합니다. */
+/* Returns the bucket that KEY hashes to. */
+static struct futex_bucket *futex_bucket(const struct futex_key *key) {
+    return &futex_table[hash_bytes(key, sizeof *key) & (FUTEX_BUCKETS - 1)];
+}
+
+/* ADDR의 워드가 아직 VAL이면 futex_wake()가 깨울 때까지 잠듭니다. 깨어났으면 0을,
+   값이 이미 바뀌었거나 ADDR이 정렬되지 않았으면 잠들지 않고 -1을 반환합니다.
+   값 확인과 대기 등록이 버킷 락 안에서 함께 일어나므로, 값을 바꾼 뒤 futex_wake()를
+   부르는 스레드의 깨우기를 놓치지 않습니다. */
+/* If the word at ADDR still holds VAL, sleeps until futex_wake()
+   wakes it and returns 0.  Returns -1 at once if the word holds
+   something else or ADDR is misaligned.  The value is checked and
+   the waiter queued under the bucket lock, which futex_wake() also
+   takes, so a wake issued after changing the word is never
+   missed. */
+int futex_wait(int *addr, int val) {
+    struct futex_waiter waiter;
+    struct futex_bucket *b;
+
+    if (!futex_key(addr, &waiter.key))
+        return -1;
+    b = futex_bucket(&waiter.key);
+
+    lock_acquire(&b->lock);
+    if (*(volatile int *)addr != val) {
+        lock_release(&b->lock);
+        return -1;
+    }
+    sema_init(&waiter.wakeup, 0);
+    list_push_back(&b->waiters, &waiter.elem);
+    lock_release(&b->lock);
+
+    sema_down(&waiter.wakeup);
+    return 0;
+}
+
+/* ADDR의 퓨텍스에서 기다리는 스레드를 먼저 잠든 순서대로 최대 N개 깨우고,
+   깨운 수를 반환합니다. */
+/* Wakes up to N threads waiting on the futex at ADDR, in the
+   order they went to sleep, and returns the number woken. */
+int futex_wake(int *addr, int n) {
+    struct futex_key key;
+    struct futex_bucket *b;
+    struct list_elem *e;
+    int woken = 0;
+
+    if (!futex_key(addr, &key))
+        return -1;
+    b = futex_bucket(&key);
+
+    lock_acquire(&b->lock);
+    for (e = list_begin(&b->waiters); e != list_end(&b->waiters) && woken < n;) {
+        struct futex_waiter *w = list_entry(e, struct futex_waiter, elem);
+
+        if (w->key.object == key.object && w->key.offset == key.offset) {
+            e = list_remove(e);
+            sema_up(&w->wakeup);
+            woken++;
+        } else
+            e = list_next(e);
+    }
+    lock_release(&b->lock);
+    return woken;
+}
@@ -130,7 +130,7 @@ anon_destroy (struct page *page) {
     if (page->frame) {
 		list_remove(&page->frame->frame_elem);
         page->frame->page = NULL;
-        free(page->frame);
+        slab_free(&frame_slab, page->frame);
         page->frame = NULL;
     }
 
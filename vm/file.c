@@ -53,7 +53,7 @@ static bool
 file_backed_swap_out (struct page *page) {
 	struct file_page *file_page UNUSED = &page->file;
     if (pml4_is_dirty(thread_current()->pml4, page->va)) {
-        file_write_at(file_page->file, page->va, file_page->page_read_bytes, file_page->offset);
+        file_write_at(file_page->file, page->frame->kva, file_page->page_read_bytes, file_page->offset);
         pml4_set_dirty(thread_current()->pml4, page->va, false);
     }
 
@@ -68,7 +68,7 @@ file_backed_swap_out (struct page *page) {
 static void file_backed_destroy(struct page *page) {
     struct file_page *file_page UNUSED = &page->file;
     if (pml4_is_dirty(thread_current()->pml4, page->va)) {
-        file_write_at(file_page->file, page->va, file_page->page_read_bytes, file_page->offset);
+        file_write_at(file_page->file, page->frame->kva, file_page->page_read_bytes, file_page->offset);
         pml4_set_dirty(thread_current()->pml4, page->va, false);
     }
  
@@ -79,7 +79,7 @@ static void file_backed_destroy(struct page *page) {
         } else {
             list_remove(&page->frame->frame_elem);
             page->frame->page = NULL;
-            free(page->frame);
+            slab_free(&frame_slab, page->frame);
             page->frame = NULL;
         }
     }
@@ -100,7 +100,7 @@ void *do_mmap(void *addr, size_t length, int writable, struct file *file, off_t
         size_t page_read_bytes = read_bytes < PGSIZE ? read_bytes : PGSIZE;
         size_t page_zero_bytes = PGSIZE - page_read_bytes;
 
-        struct container *container = (struct container *)malloc(sizeof(struct container));
+        struct container *container = slab_alloc(&container_slab);
         if (!container)
             goto err;
 
@@ -109,7 +109,7 @@ void *do_mmap(void *addr, size_t length, int writable, struct file *file, off_t
         container->page_read_bytes = page_read_bytes;
 
         if (!vm_alloc_page_with_initializer(VM_FILE, addr, writable, lazy_load_segment, container)) {
-            free(container);
+            slab_free(&container_slab, container);
             goto err;
         }
 
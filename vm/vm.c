@@ -1,12 +1,18 @@
 /* vm.c: Generic interface for virtual memory objects. */
 
-#include "threads/malloc.h"
 #include "vm/vm.h"
+#include "threads/trace.h"
 #include "threads/vaddr.h"
 #include "vm/inspect.h"
+#include "userprog/process.h"
 #include <hash.h>
 
 static struct list frame_table;
+
+/* Object caches for pages, frames and lazy-load containers. */
+struct slab_cache page_slab;
+struct slab_cache frame_slab;
+struct slab_cache container_slab;
 /* Initializes the virtual memory subsystem by invoking each subsystem's
  * intialize codes. */
 void
@@ -20,6 +26,9 @@ vm_init (void) {
 	/* DO NOT MODIFY UPPER LINES. */
 	/* TODO: Your code goes here. */
 	list_init(&frame_table);
+	slab_cache_init (&page_slab, "page", sizeof (struct page), NULL);
+	slab_cache_init (&frame_slab, "frame", sizeof (struct frame), NULL);
+	slab_cache_init (&container_slab, "container", sizeof (struct container), NULL);
 }
 
 /* Get the type of the page. This function is useful if you want to know the
@@ -60,7 +69,7 @@ vm_alloc_page_with_initializer (enum vm_type type, void *upage, bool writable,
 		 * TODO: should modify the field after calling the uninit_new. */
 
 		/* TODO: Insert the page into the spt. */
-		struct page *p = (struct page*)malloc(sizeof(struct page));
+		struct page *p = slab_alloc (&page_slab);
 		bool (*page_initializer)(struct page *, enum vm_type, void *);
 
 		switch (VM_TYPE(type))
@@ -85,14 +94,11 @@ err:
 /* Find VA from spt and return page. On error, return NULL. */
 struct page *
 spt_find_page (struct supplemental_page_table *spt UNUSED, void *va UNUSED) {
-	struct page *page = NULL;
+	struct page key;
 	/* TODO: Fill this function. */
-	page = (struct page *)malloc(sizeof(struct page)); // va를 찾기 위한 임시 페이지 할당
-	page -> va = pg_round_down(va);
+	key.va = pg_round_down(va); // va를 찾기 위한 검색 키 (스택에 두어 할당하지 않음)
 
-	struct hash_elem *e = hash_find(&spt->spt_hash, &page->hash_elem);
-	free(page); // 임시 페이지 해제
-	page = hash_entry(e, struct page, hash_elem);
+	struct hash_elem *e = hash_find(&spt->spt_hash, &key.hash_elem);
     return e != NULL ? hash_entry(e, struct page, hash_elem) : NULL;
 }
 
@@ -148,7 +154,7 @@ static struct frame *vm_evict_frame(void) {
  *  이는 항상 유효한 주소를 반환합니다. 즉, 사용자 풀 메모리가 가득 찬 경우 이 함수는 사용 가능한 메모리 공간을 확보하기 위해 프레임을 제거합니다.*/
 static struct frame *vm_get_frame(void) {
     /* TODO: Fill this function. */
-    struct frame *frame = (struct frame *)malloc(sizeof(struct frame));
+    struct frame *frame = slab_alloc(&frame_slab);
 	frame->reference_cnt = 1;
     ASSERT(frame != NULL);
 
@@ -206,7 +212,12 @@ bool
 vm_try_handle_fault (struct intr_frame *f UNUSED, void *addr UNUSED,
 		bool user UNUSED, bool write UNUSED, bool not_present UNUSED) {
 	struct supplemental_page_table *spt UNUSED = &thread_current ()->spt;
-	struct page *page = spt_find_page(spt, addr);
+	struct page *page;
+
+	TRACE (TRACE_PAGE_FAULT, addr, (user ? TRACE_PF_USER : 0)
+			| (write ? TRACE_PF_WRITE : 0)
+			| (not_present ? TRACE_PF_NOT_PRESENT : 0));
+	page = spt_find_page(spt, addr);
 
 	/* TODO: Validate the fault */
     if (addr == NULL || is_kernel_vaddr(addr))
@@ -237,7 +248,7 @@ vm_try_handle_fault (struct intr_frame *f UNUSED, void *addr UNUSED,
 void
 vm_dealloc_page (struct page *page) {
 	destroy (page);
-	free (page);
+	slab_free (&page_slab, page);
 }
 
 /* Claim the page that allocate on VA. */
@@ -348,7 +359,7 @@ bool vm_copy_claim_page(struct supplemental_page_table *dst, void *va, void *kva
 	if (page == NULL)
 		return false;
 
-	struct frame *frame = (struct frame *)malloc(sizeof(struct frame));
+	struct frame *frame = slab_alloc(&frame_slab);
 
 	if (!frame)
 		return false;
@@ -360,7 +371,7 @@ bool vm_copy_claim_page(struct supplemental_page_table *dst, void *va, void *kva
 	frame->kva = kva;
 
 	if(!pml4_set_page(thread_current()->pml4, page->va, frame->kva, false)) {
-		free(frame);
+		slab_free(&frame_slab, frame);
 		return false;
 	}
 